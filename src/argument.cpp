@@ -35,18 +35,18 @@ argument::argument(const shape& s) : m_shape(s)
 }
 
 argument::argument(shape s, std::nullptr_t)
-    : m_shape(std::move(s)), m_data({[] { return nullptr; }})
+    : m_shape(std::move(s)), m_data([] { return nullptr; }, true)
 {
 }
 
 argument::argument(const shape& s, const argument::data_t& d) : m_shape(s), m_data(d) {}
 
-void argument::assign_buffer(std::function<char*()> d)
+void argument::assign_buffer(std::function<char*()> d, bool shared)
 {
     const shape& s = m_shape;
     if(s.type() != shape::tuple_type)
     {
-        m_data = {std::move(d)};
+        m_data = {std::move(d), shared};
         return;
     }
     // Collect all shapes
@@ -88,7 +88,7 @@ void argument::assign_buffer(std::function<char*()> d)
         if(ss.sub_shapes().empty())
         {
             auto n = offsets[i];
-            result = {[d, n]() mutable { return d() + n; }};
+            result = {[d, n]() mutable { return d() + n; }, shared};
             i++;
             return result;
         }
@@ -120,7 +120,7 @@ char* argument::data() const
 {
     assert(m_shape.type() != shape::tuple_type);
     assert(not this->empty());
-    return m_data.get();
+    return (*m_data.get)();
 }
 
 bool argument::empty() const { return not m_data.get and m_data.sub.empty(); }
@@ -133,14 +133,31 @@ argument argument::reshape(const shape& s) const
     return {s, this->m_data};
 }
 
+argument::data_t::data_t(std::function<char*()> f, bool s)
+    : get(std::make_shared<std::function<char*()>>(std::move(f))), shared(s)
+{
+}
+
+argument::data_t::data_t(const data_t& d) : shared(d.shared), sub(d.sub)
+{
+    if(d.get == nullptr or d.shared)
+        get = d.get;
+    else
+        get = std::make_shared<std::function<char*()>>(*d.get);
+}
+
+argument::data_t& argument::data_t::operator=(const data_t& d)
+{
+    data_t copy{d};
+    *this = std::move(copy);
+    return *this;
+}
+
 argument::data_t argument::data_t::share() const
 {
     data_t result;
     if(this->get)
-    {
-        auto self  = std::make_shared<data_t>(*this);
-        result.get = [self]() mutable { return self->get(); };
-    }
+        result.get = this->shared ? this->get : std::make_shared<std::function<char*()>>(*get);
     std::transform(sub.begin(), sub.end(), std::back_inserter(result.sub), [](const auto& d) {
         return d.share();
     });
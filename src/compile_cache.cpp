@@ -0,0 +1,220 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/compile_cache.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <migraphx/tmp_dir.hpp>
+#include <migraphx/env.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <tuple>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_COMPILE_CACHE)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_COMPILE_CACHE_DIR)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_COMPILE_CACHE_SIZE)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_COMPILE_CACHE)
+
+cache_key_builder& cache_key_builder::add(const char* data, std::size_t n)
+{
+    std::for_each(data, data + n, [&](char c) {
+        auto x = static_cast<unsigned char>(c);
+        h1     = (h1 ^ x) * 1099511628211ULL;
+        h2     = (h2 + x) * 0xff51afd7ed558ccdULL;
+        h2 ^= h2 >> 32U;
+    });
+    return *this;
+}
+
+cache_key_builder& cache_key_builder::add(const std::string& s)
+{
+    // Hash the length so adjacent fields can't run into each other
+    auto n = std::to_string(s.size()) + ":";
+    add(n.data(), n.size());
+    return add(s.data(), s.size());
+}
+
+std::string cache_key_builder::str() const
+{
+    std::stringstream ss;
+    ss << std::hex << std::setfill('0') << std::setw(16) << h1 << std::setw(16) << h2;
+    return ss.str();
+}
+
+compile_cache::compile_cache(fs::path d, std::size_t max) : dir(std::move(d)), max_size(max)
+{
+    fs::create_directories(dir);
+}
+
+fs::path compile_cache::path(const std::string& key) const { return dir / (key + ".bin"); }
+
+static void trace(const compile_cache& c, const char* event, const std::string& key)
+{
+    if(not enabled(MIGRAPHX_TRACE_COMPILE_CACHE{}))
+        return;
+    std::cout << "compile cache " << event << ": " << key << " (hits: " << c.hits
+              << ", misses: " << c.misses << ")" << std::endl;
+}
+
+optional<std::vector<char>> compile_cache::lookup(const std::string& key)
+{
+    auto p = path(key);
+    std::error_code ec;
+    if(fs::exists(p, ec))
+    {
+        try
+        {
+            auto result = read_buffer(p.string());
+            // Refresh the timestamp so eviction sees this entry as recently used
+            fs::last_write_time(p, fs::file_time_type::clock::now(), ec);
+            hits++;
+            trace(*this, "hit", key);
+            return result;
+        }
+        catch(const std::exception&)
+        {
+            // The entry was evicted by another process while reading it
+        }
+    }
+    misses++;
+    trace(*this, "miss", key);
+    return nullopt;
+}
+
+void compile_cache::store(const std::string& key, const std::vector<char>& data)
+{
+    // Write to a private file first and then rename, so readers never see a
+    // partially written entry
+    auto tmp = dir / (unique_string(key) + ".tmp");
+    write_buffer(tmp.string(), data);
+    std::error_code ec;
+    fs::rename(tmp, path(key), ec);
+    if(ec)
+        fs::remove(tmp, ec);
+    evict();
+}
+
+struct cache_entry
+{
+    fs::file_time_type time;
+    std::size_t size;
+    fs::path path;
+};
+
+static std::vector<cache_entry> list_entries(const fs::path& dir)
+{
+    std::vector<cache_entry> result;
+    std::error_code ec;
+    for(const auto& entry : fs::directory_iterator{dir, ec})
+    {
+        const auto& p = entry.path();
+        if(p.extension() != ".bin")
+            continue;
+        auto size = fs::file_size(p, ec);
+        if(ec)
+            continue;
+        auto time = fs::last_write_time(p, ec);
+        if(ec)
+            continue;
+        result.push_back({time, size, p});
+    }
+    return result;
+}
+
+std::size_t compile_cache::size() const
+{
+    auto entries = list_entries(dir);
+    return std::accumulate(entries.begin(),
+                           entries.end(),
+                           std::size_t{0},
+                           [](std::size_t n, const cache_entry& e) { return n + e.size; });
+}
+
+void compile_cache::evict() const
+{
+    auto entries = list_entries(dir);
+    auto total   = std::accumulate(entries.begin(),
+                                 entries.end(),
+                                 std::size_t{0},
+                                 [](std::size_t n, const cache_entry& e) { return n + e.size; });
+    if(total <= max_size)
+        return;
+    std::sort(entries.begin(), entries.end(), [](const auto& x, const auto& y) {
+        return std::tie(x.time, x.path) < std::tie(y.time, y.path);
+    });
+    std::error_code ec;
+    for(const auto& e : entries)
+    {
+        if(total <= max_size)
+            break;
+        // Another process may have removed it already, which is fine
+        fs::remove(e.path, ec);
+        total -= e.size;
+    }
+}
+
+static fs::path default_cache_dir()
+{
+    auto dir = string_value_of(MIGRAPHX_COMPILE_CACHE_DIR{});
+    if(not dir.empty())
+        return dir;
+    auto xdg = string_value_of("XDG_CACHE_HOME");
+    if(not xdg.empty())
+        return fs::path{xdg} / "migraphx" / "compile";
+    auto home = string_value_of("HOME");
+    if(not home.empty())
+        return fs::path{home} / ".cache" / "migraphx" / "compile";
+    return {};
+}
+
+compile_cache* get_compile_cache()
+{
+    static compile_cache* result = []() -> compile_cache* {
+        if(enabled(MIGRAPHX_DISABLE_COMPILE_CACHE{}))
+            return nullptr;
+        auto dir = default_cache_dir();
+        if(dir.empty())
+            return nullptr;
+        // Size is given in MiB
+        auto max = value_of(MIGRAPHX_COMPILE_CACHE_SIZE{}, 1024) * 1024 * 1024;
+        try
+        {
+            static compile_cache c{dir, max};
+            return &c;
+        }
+        catch(const std::exception&)
+        {
+            // Caching is best effort, so an unwritable directory just disables it
+            return nullptr;
+        }
+    }();
+    return result;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -22,24 +22,60 @@
  * THE SOFTWARE.
  */
 #include <migraphx/compile_src.hpp>
+#include <migraphx/compile_cache.hpp>
+#include <migraphx/process.hpp>
 #include <migraphx/file_buffer.hpp>
 #include <migraphx/tmp_dir.hpp>
 #include <migraphx/stringutils.hpp>
 #include <migraphx/errors.hpp>
 #include <cassert>
+#include <mutex>
+#include <unordered_map>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
-std::vector<char> src_compiler::compile(const std::vector<src_file>& srcs) const
+static std::string compiler_version(const std::string& compiler)
+{
+    static std::mutex m;
+    static std::unordered_map<std::string, std::string> versions;
+    std::lock_guard<std::mutex> lock(m);
+    auto it = versions.find(compiler);
+    if(it != versions.end())
+        return it->second;
+    std::string version;
+    try
+    {
+        version = process{compiler + " --version"}.read();
+    }
+    catch(const std::exception&)
+    {
+        // Fall back to just the compiler name in the key
+    }
+    versions.emplace(compiler, version);
+    return version;
+}
+
+std::string src_compiler::cache_key(const std::vector<src_file>& srcs) const
+{
+    cache_key_builder key;
+    key.add(compiler).add(compiler_version(compiler)).add(flags).add(output).add(out_ext);
+    for(const auto& src : srcs)
+    {
+        key.add(src.path.string());
+        key.add(src.content.first, src.len());
+    }
+    return key.str();
+}
+
+static std::vector<char> compile_uncached(const src_compiler& sc, const std::vector<src_file>& srcs)
 {
-    assert(not srcs.empty());
     tmp_dir td{"compile"};
-    auto params = flags;
+    auto params = sc.flags;
 
     params += " -I.";
 
-    auto out = output;
+    auto out = sc.output;
 
     for(const auto& src : srcs)
     {
@@ -51,30 +87,54 @@ std::vector<char> src_compiler::compile(const std::vector<src_file>& srcs) const
         {
             params += " " + src.path.filename().string();
             if(out.empty())
-                out = src.path.stem().string() + out_ext;
+                out = src.path.stem().string() + sc.out_ext;
         }
     }
 
     params += " -o " + out;
 
-    if(not launcher.empty())
+    if(not sc.launcher.empty())
     {
-        td.execute(launcher, compiler + " " + params);
+        td.execute(sc.launcher, sc.compiler + " " + params);
     }
     else
     {
-        td.execute(compiler, params);
+        td.execute(sc.compiler, params);
     }
 
     auto out_path = td.path / out;
     if(not fs::exists(out_path))
         MIGRAPHX_THROW("Output file missing: " + out);
 
-    if(process)
-        out_path = process(out_path);
+    if(sc.process)
+        out_path = sc.process(out_path);
 
     return read_buffer(out_path.string());
 }
 
+std::vector<char> src_compiler::compile(const std::vector<src_file>& srcs) const
+{
+    assert(not srcs.empty());
+    auto* cache = get_compile_cache();
+    // The result of a post processing step can't be captured by the key
+    if(cache == nullptr or process)
+        return compile_uncached(*this, srcs);
+    auto key = cache_key(srcs);
+    if(auto cached = cache->lookup(key))
+        return *cached;
+    auto result = compile_uncached(*this, srcs);
+    cache->store(key, result);
+    return result;
+}
+
+std::vector<std::vector<char>> compile_all(const std::vector<src_compile_job>& jobs,
+                                           const job_server& js)
+{
+    std::vector<std::vector<char>> results(jobs.size());
+    js.run(jobs.size(),
+           [&](std::size_t i) { results[i] = jobs[i].compiler.compile(jobs[i].srcs); });
+    return results;
+}
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
@@ -47,6 +47,7 @@
 #include <migraphx/simplify_algebra.hpp>
 #include <migraphx/simplify_reshapes.hpp>
 #include <migraphx/register_target.hpp>
+#include <migraphx/time.hpp>
 
 #include <fstream>
 
@@ -172,6 +173,7 @@ struct loader
                     file_type = "migraphx";
             }
             std::cout << "Reading: " << file << std::endl;
+            timer t{};
             if(file_type == "onnx")
             {
                 onnx_options options;
@@ -195,6 +197,8 @@ struct loader
             {
                 p = migraphx::load(file);
             }
+            using milliseconds = std::chrono::duration<double, std::milli>;
+            std::cout << "Loaded in " << t.record<milliseconds>() << "ms" << std::endl;
         }
         else
         {
@@ -402,8 +406,10 @@ struct verify : command<verify>
     double tolerance     = 80;
     bool per_instruction = false;
     bool reduce          = false;
+    bool bisect          = false;
     bool offload_copy    = false;
     bool fast_math       = true;
+    std::size_t jobs     = 0;
     precision quantize   = precision::fp32;
     void parse(argument_parser& ap)
     {
@@ -423,7 +429,16 @@ struct verify : command<verify>
            {"-i", "--per-instruction"},
            ap.help("Verify each instruction"),
            ap.set_value(true));
+        ap(jobs,
+           {"--jobs", "-j"},
+           ap.help("Number of programs verified concurrently with --per-instruction or --bisect "
+                   "(default: number of cores)"));
         ap(reduce, {"-r", "--reduce"}, ap.help("Reduce program and verify"), ap.set_value(true));
+        ap(bisect,
+           {"-b", "--bisect"},
+           ap.help("Find the first diverging instruction with a binary search over the reduced "
+                   "programs"),
+           ap.set_value(true));
         ap(quantize, {"--fp16"}, ap.help("Quantize for fp16"), ap.set_value(precision::fp16));
     }
 
@@ -441,12 +456,16 @@ struct verify : command<verify>
 
         if(per_instruction)
         {
-            verify_instructions(p, t, options, quantize, tolerance);
+            verify_instructions(p, t, options, quantize, tolerance, jobs);
         }
         else if(reduce)
         {
             verify_reduced_program(p, t, options, quantize, m, tolerance);
         }
+        else if(bisect)
+        {
+            verify_bisect_program(p, t, options, quantize, m, tolerance, jobs);
+        }
         else
         {
             verify_program(l.file, p, t, options, quantize, m, tolerance);
@@ -496,10 +515,21 @@ struct perf : command<perf>
 {
     compiler c;
     unsigned n = 100;
+    perf_options options;
     void parse(argument_parser& ap)
     {
         c.parse(ap);
         ap(n, {"--iterations", "-n"}, ap.help("Number of iterations to run for perf report"));
+        ap(options.counters,
+           {"--counters"},
+           ap.help("Read the hardware counters of the host for each instruction"),
+           ap.set_value(true));
+        ap(options.peak_gflops,
+           {"--peak-gflops"},
+           ap.help("Peak GFLOP/s of the device, used to find the bounds in the roofline summary"));
+        ap(options.peak_gbs,
+           {"--peak-gbs"},
+           ap.help("Peak memory bandwidth in GB/s of the device for the roofline summary"));
     }
 
     void run()
@@ -509,7 +539,7 @@ struct perf : command<perf>
         std::cout << "Allocating params ... " << std::endl;
         auto m = c.params(p);
         std::cout << "Running performance report ... " << std::endl;
-        p.perf_report(std::cout, n, m, c.l.batch);
+        p.perf_report(std::cout, n, m, c.l.batch, options);
     }
 };
 
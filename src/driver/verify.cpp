@@ -30,16 +30,27 @@
 #include <migraphx/instruction.hpp>
 #include <migraphx/compile_options.hpp>
 #include <migraphx/quantization.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/ranges.hpp>
+
+#include <atomic>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace migraphx {
 namespace driver {
 inline namespace MIGRAPHX_INLINE_NS {
 
-std::vector<argument> run_ref(program p, const parameter_map& inputs)
+std::vector<argument> run_ref(program p, const parameter_map& inputs, bool trace = true)
 {
     p.compile(ref::target{});
     auto out = p.eval(inputs);
-    std::cout << p << std::endl;
+    if(trace)
+        std::cout << p << std::endl;
     return out;
 }
 
@@ -47,7 +58,8 @@ std::vector<argument> run_target(program p,
                                  const target& t,
                                  const compile_options& options,
                                  precision quantize,
-                                 const parameter_map& inputs)
+                                 const parameter_map& inputs,
+                                 bool trace = true)
 {
     if(quantize == precision::fp16)
     {
@@ -63,7 +75,8 @@ std::vector<argument> run_target(program p,
     }
     auto gpu_out = p.eval(m);
     std::vector<argument> output(gpu_out.size());
-    std::cout << p << std::endl;
+    if(trace)
+        std::cout << p << std::endl;
     std::transform(gpu_out.begin(), gpu_out.end(), output.begin(), [&](auto& argu) {
         return options.offload_copy ? argu : t.copy_from(argu);
     });
@@ -88,50 +101,194 @@ void verify_program(const std::string& name,
     }
 }
 
+static bool skip_instruction(const instruction& ins)
+{
+    static const std::unordered_set<std::string> skipped = {
+        "broadcast", "transpose", "reshape", "undefined"};
+    return ins.name().front() == '@' or contains(skipped, ins.name());
+}
+
+// Instructions with the same operator and the same inputs produce the same single-instruction
+// program, so they only need to be verified once
+static std::string instruction_signature(const module& m, const instruction& ins)
+{
+    std::stringstream ss;
+    ss << ins.get_operator();
+    for(auto&& arg : ins.inputs())
+    {
+        ss << ", " << arg->get_shape();
+        if(arg->name() == "@literal")
+            ss << " @literal:" << std::distance(m.begin(), arg);
+    }
+    return ss.str();
+}
+
+static program make_instruction_program(const instruction& ins)
+{
+    program p;
+    auto* mm_p = p.get_main_module();
+    std::vector<instruction_ref> inputs;
+    for(auto&& arg : ins.inputs())
+    {
+        if(arg->name() == "@literal")
+            inputs.push_back(mm_p->add_literal(arg->get_literal()));
+        else
+            inputs.push_back(mm_p->add_parameter(std::to_string(inputs.size()), arg->get_shape()));
+    }
+    mm_p->add_instruction(ins.get_operator(), inputs);
+    return p;
+}
+
+// Compares the outputs without printing them, and returns the largest error
+static bool compare_outputs(const std::vector<argument>& x,
+                            const std::vector<argument>& y,
+                            double tolerance,
+                            double& max_error)
+{
+    bool passed = true;
+    for(std::size_t i = 0; i < x.size(); ++i)
+    {
+        visit_all(x[i], y[i])([&](auto ref, auto result) {
+            double error = 0;
+            passed       = verify_range(ref, result, tolerance, &error) and passed;
+            max_error    = std::max(max_error, error);
+        });
+    }
+    return passed;
+}
+
+struct instruction_verification
+{
+    program prog;
+    std::string name;
+    std::size_t count = 0;
+    double error      = 0;
+    bool passed       = true;
+    std::exception_ptr exception;
+};
+
+static void verify_instruction(instruction_verification& v,
+                               const target& t,
+                               const compile_options& options,
+                               precision quantize,
+                               double tolerance)
+{
+    try
+    {
+        auto inputs = create_param_map(v.prog, false);
+        auto x      = run_ref(v.prog, inputs, false);
+        auto y      = run_target(v.prog, t, options, quantize, inputs, false);
+        v.passed    = compare_outputs(x, y, tolerance, v.error);
+    }
+    catch(...)
+    {
+        v.passed    = false;
+        v.exception = std::current_exception();
+    }
+}
+
 void verify_instructions(const program& prog,
                          const target& t,
                          compile_options options,
                          precision quantize,
-                         double tolerance)
+                         double tolerance,
+                         std::size_t jobs)
 {
     const auto* mm_prog = prog.get_main_module();
+    std::vector<instruction_verification> verifications;
+    std::unordered_map<std::string, std::size_t> signatures;
     for(auto&& ins : (*mm_prog))
     {
-        if(ins.name().front() == '@')
+        if(skip_instruction(ins))
             continue;
-        if(ins.name() == "broadcast")
-            continue;
-        if(ins.name() == "transpose")
-            continue;
-        if(ins.name() == "reshape")
-            continue;
-        if(ins.name() == "undefined")
-            continue;
-        program p;
-        auto* mm_p = p.get_main_module();
-        std::vector<instruction_ref> inputs;
-        for(auto&& arg : ins.inputs())
+        auto signature = instruction_signature(*mm_prog, ins);
+        auto it        = signatures.find(signature);
+        if(it == signatures.end())
+        {
+            it = signatures.emplace(signature, verifications.size()).first;
+            verifications.push_back({make_instruction_program(ins), ins.name()});
+        }
+        verifications[it->second].count++;
+    }
+
+    if(jobs == 0)
+        jobs = std::thread::hardware_concurrency();
+    jobs = std::max<std::size_t>(1, std::min(jobs, verifications.size()));
+    std::cout << "Verify " << verifications.size() << " unique instructions using " << jobs
+              << " jobs" << std::endl;
+
+    // Each worker takes the next unverified instruction, so expensive instructions don't hold up
+    // the others
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> done{0};
+    std::mutex m;
+    par_for_impl(jobs, jobs, [&](auto) {
+        for(auto i = next++; i < verifications.size(); i = next++)
         {
-            if(arg->name() == "@literal")
-                inputs.push_back(mm_p->add_literal(arg->get_literal()));
-            else
-                inputs.push_back(
-                    mm_p->add_parameter(std::to_string(inputs.size()), arg->get_shape()));
+            verify_instruction(verifications[i], t, options, quantize, tolerance);
+            auto n = ++done;
+            std::lock_guard<std::mutex> lock(m);
+            std::cout << "\r[" << n << "/" << verifications.size() << "]" << std::flush;
         }
-        mm_p->add_instruction(ins.get_operator(), inputs);
-        try
+    });
+    std::cout << std::endl;
+
+    struct op_summary
+    {
+        std::size_t count  = 0;
+        std::size_t unique = 0;
+        std::size_t failed = 0;
+        double error       = 0;
+    };
+    std::map<std::string, op_summary> summary;
+    std::exception_ptr first_exception;
+    for(auto&& v : verifications)
+    {
+        auto& s = summary[v.name];
+        s.count += v.count;
+        s.unique++;
+        s.error = std::max(s.error, v.error);
+        if(v.passed)
+            continue;
+        s.failed++;
+        std::cout << "FAILED: " << v.name << std::endl;
+        std::cout << v.prog << std::endl;
+        if(v.exception)
         {
-            std::cout << "Verify: " << ins.name() << std::endl;
-            std::cout << p << std::endl;
-            verify_program(
-                ins.name(), p, t, options, quantize, create_param_map(p, false), tolerance);
+            try
+            {
+                std::rethrow_exception(v.exception);
+            }
+            catch(const std::exception& e)
+            {
+                std::cout << "Exception: " << e.what() << std::endl;
+            }
+            catch(...)
+            {
+                std::cout << "Unknown exception" << std::endl;
+            }
+            if(not first_exception)
+                first_exception = v.exception;
         }
-        catch(...)
+        else
         {
-            std::cout << "Instruction " << ins.name() << " threw an exception." << std::endl;
-            throw;
+            std::cout << "error: " << v.error << std::endl;
         }
+        std::cout << std::endl;
     }
+
+    std::cout << std::left << std::setw(32) << "Operator" << std::right << std::setw(10)
+              << "Count" << std::setw(10) << "Unique" << std::setw(10) << "Failed"
+              << std::setw(16) << "Max error" << std::endl;
+    for(auto&& p : summary)
+    {
+        std::cout << std::left << std::setw(32) << p.first << std::right << std::setw(10)
+                  << p.second.count << std::setw(10) << p.second.unique << std::setw(10)
+                  << p.second.failed << std::setw(16) << p.second.error << std::endl;
+    }
+
+    if(first_exception)
+        std::rethrow_exception(first_exception);
 }
 
 void verify_reduced(program p,
@@ -166,6 +323,150 @@ void verify_reduced_program(const program& p,
     }
 }
 
+// Keeps the first n instructions of the main module. Every value still used after the cut is
+// returned along with the last instruction, so when a reduced program matches, all the inputs of
+// the next instruction match too. Returning only the last instruction would miss a divergence on
+// another branch of the graph.
+static program make_prefix_program(const program& p, std::size_t n)
+{
+    program result = p;
+    auto* mm       = result.get_main_module();
+    auto cut       = std::next(mm->begin(), n);
+    std::unordered_set<instruction_ref> prefix;
+    for(auto ins = mm->begin(); ins != cut; ++ins)
+        prefix.insert(ins);
+    std::vector<instruction_ref> live;
+    for(auto ins = mm->begin(); ins != cut; ++ins)
+    {
+        if(ins->name().front() == '@')
+            continue;
+        if(std::next(ins) == cut or any_of(ins->outputs(), [&](auto output) {
+               return not contains(prefix, output);
+           }))
+            live.push_back(ins);
+    }
+    mm->remove_instructions(cut, mm->end());
+    mm->add_return(live);
+    return result;
+}
+
+struct prefix_verification
+{
+    bool passed  = true;
+    double error = 0;
+    std::string message;
+};
+
+static prefix_verification verify_prefix(const program& p,
+                                         std::size_t n,
+                                         const target& t,
+                                         const compile_options& options,
+                                         precision quantize,
+                                         const parameter_map& inputs,
+                                         double tolerance)
+{
+    prefix_verification result;
+    try
+    {
+        auto reduced  = make_prefix_program(p, n);
+        auto x        = run_ref(reduced, inputs, false);
+        auto y        = run_target(reduced, t, options, quantize, inputs, false);
+        result.passed = compare_outputs(x, y, tolerance, result.error);
+    }
+    catch(const std::exception& e)
+    {
+        result.passed  = false;
+        result.message = e.what();
+    }
+    return result;
+}
+
+void verify_bisect_program(const program& p,
+                           const target& t,
+                           compile_options options,
+                           precision quantize,
+                           const parameter_map& inputs,
+                           double tolerance,
+                           std::size_t jobs)
+{
+    // Only truncate after the instructions that compute something
+    const auto* mm = p.get_main_module();
+    std::vector<std::size_t> candidates;
+    std::size_t n = 0;
+    for(auto&& ins : *mm)
+    {
+        n++;
+        if(ins.name().front() != '@')
+            candidates.push_back(n);
+    }
+    if(candidates.empty())
+        return;
+    if(jobs == 0)
+        jobs = std::thread::hardware_concurrency();
+    jobs = std::max<std::size_t>(1, jobs);
+
+    // Results of the reduced programs, by the number of instructions kept
+    std::map<std::size_t, prefix_verification> cache;
+    std::size_t runs = 0;
+    auto check       = [&](const std::vector<std::size_t>& points) {
+        std::vector<std::size_t> missing;
+        std::copy_if(points.begin(), points.end(), std::back_inserter(missing), [&](auto i) {
+            return not contains(cache, candidates[i]);
+        });
+        std::vector<prefix_verification> results(missing.size());
+        par_for_impl(missing.size(), std::min(jobs, missing.size()), [&](auto i) {
+            results[i] =
+                verify_prefix(p, candidates[missing[i]], t, options, quantize, inputs, tolerance);
+        });
+        for(std::size_t i = 0; i < missing.size(); i++)
+            cache[candidates[missing[i]]] = results[i];
+        runs += missing.size();
+    };
+
+    // The whole program has to diverge. After that, the candidates before lo pass and the one at
+    // hi diverges, which is narrowed down with up to jobs candidates checked at each step.
+    std::size_t lo = 0;
+    std::size_t hi = candidates.size() - 1;
+    check({hi});
+    if(cache.at(candidates[hi]).passed)
+    {
+        std::cout << "No divergence found" << std::endl;
+        return;
+    }
+    for(std::size_t step = 1; lo < hi; step++)
+    {
+        std::size_t count = std::min(jobs, hi - lo);
+        std::vector<std::size_t> points;
+        for(std::size_t j = 1; j <= count; j++)
+            points.push_back(lo + (hi - lo) * j / (count + 1));
+        points.erase(std::unique(points.begin(), points.end()), points.end());
+        std::cout << "Step " << step << ": checking " << points.size()
+                  << " reduced programs between instructions " << candidates[lo] << " and "
+                  << candidates[hi] << std::endl;
+        check(points);
+        for(auto i : points)
+        {
+            if(not cache.at(candidates[i]).passed)
+            {
+                hi = i;
+                break;
+            }
+            lo = i + 1;
+        }
+    }
+
+    const auto& result = cache.at(candidates[hi]);
+    auto reduced       = make_prefix_program(p, candidates[hi]);
+    auto ins           = std::prev(reduced.get_main_module()->end(), 2);
+    std::cout << "First diverging instruction found after " << runs << " runs: " << candidates[hi]
+              << ": " << ins->get_operator() << " -> " << ins->get_shape() << std::endl;
+    std::cout << reduced << std::endl;
+    if(result.message.empty())
+        std::cout << "error: " << result.error << std::endl;
+    else
+        std::cout << "Exception: " << result.message << std::endl;
+}
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace driver
 } // namespace migraphx
@@ -42,13 +42,21 @@ void verify_instructions(const program& prog,
                          const target& t,
                          compile_options options = compile_options{},
                          precision quantize      = precision::fp32,
-                         double tolerance        = 80);
+                         double tolerance        = 80,
+                         std::size_t jobs        = 0);
 void verify_reduced_program(const program& p,
                             const target& t,
                             compile_options options     = compile_options{},
                             precision quantize          = precision::fp32,
                             const parameter_map& inputs = {},
                             double tolerance            = 80);
+void verify_bisect_program(const program& p,
+                           const target& t,
+                           compile_options options     = compile_options{},
+                           precision quantize          = precision::fp32,
+                           const parameter_map& inputs = {},
+                           double tolerance            = 80,
+                           std::size_t jobs            = 0);
 
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace driver
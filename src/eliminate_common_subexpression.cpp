@@ -36,7 +36,7 @@ inline namespace MIGRAPHX_INLINE_NS {
 template <class Range>
 void cse_range(module& m, Range&& r)
 {
-    std::unordered_multimap<std::string, instruction_ref> instructions;
+    std::unordered_multimap<std::size_t, instruction_ref> instructions;
     std::unordered_set<instruction_ref> processed_ins;
     for(auto ins : r)
     {
@@ -44,8 +44,8 @@ void cse_range(module& m, Range&& r)
         if(ins->outputs().empty())
             continue;
 
-        // Find instruction with the same name
-        auto found_instructions = range(instructions.equal_range(ins->name()));
+        // Find instructions with the same operator hash
+        auto found_instructions = range(instructions.equal_range(ins->get_operator_hash()));
         for(const auto& pp : found_instructions)
         {
             auto eq = pp.second;
@@ -66,7 +66,7 @@ void cse_range(module& m, Range&& r)
             });
             cse_range(m, outputs);
         }
-        instructions.emplace(ins->name(), ins);
+        instructions.emplace(ins->get_operator_hash(), ins);
     }
 }
 
@@ -0,0 +1,84 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/eval_plan.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/builtin.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+eval_plan make_eval_plan(const module& m)
+{
+    eval_plan plan;
+    plan.steps.reserve(m.size());
+    plan.slots.reserve(m.size());
+    for(auto ins : iterator_for(m))
+    {
+        eval_step step;
+        step.ins         = ins;
+        const auto& name = ins->name();
+        if(name == "@literal")
+        {
+            // Share the buffer of the literal instead of copying it, the
+            // aliasing pointer keeps the literal alive
+            auto lit   = std::make_shared<literal>(ins->get_literal());
+            auto data  = const_cast<char*>(lit->data()); // NOLINT
+            step.kind  = eval_step::constant;
+            step.value = argument{lit->get_shape(), std::shared_ptr<char>(lit, data)};
+        }
+        else if(name == "@outline")
+        {
+            step.kind  = eval_step::constant;
+            step.value = argument{ins->get_shape(), nullptr};
+        }
+        else if(name == "@param")
+        {
+            step.kind  = eval_step::parameter;
+            step.param = any_cast<builtin::param>(ins->get_operator()).parameter;
+        }
+        else
+        {
+            step.kind = name == "@return" ? eval_step::returns : eval_step::compute;
+            if(step.kind == eval_step::compute)
+                step.op = ins->normalized_operator();
+            std::transform(ins->inputs().begin(),
+                           ins->inputs().end(),
+                           std::back_inserter(step.inputs),
+                           [&](instruction_ref input) {
+                               auto it = plan.slots.find(input);
+                               if(it == plan.slots.end())
+                                   return eval_step::outer;
+                               return it->second;
+                           });
+        }
+        plan.slots.emplace(ins, plan.steps.size());
+        plan.steps.push_back(std::move(step));
+    }
+    return plan;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
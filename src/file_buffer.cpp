@@ -30,23 +30,31 @@ namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
 template <class T>
-T generic_read_file(const std::string& filename)
+T generic_read_file(const std::string& filename, std::size_t offset = 0, std::size_t nbytes = 0)
 {
     std::ifstream is(filename, std::ios::binary | std::ios::ate);
-    std::streamsize size = is.tellg();
-    if(size < 1)
+    std::streamsize fsize = is.tellg();
+    if(fsize < 1)
         MIGRAPHX_THROW("Invalid size for: " + filename);
-    is.seekg(0, std::ios::beg);
+    auto size = static_cast<std::size_t>(fsize);
+    if(offset > size)
+        MIGRAPHX_THROW("Invalid offset " + std::to_string(offset) + " for: " + filename);
+    if(nbytes == 0)
+        nbytes = size - offset;
+    else if(nbytes > size - offset)
+        MIGRAPHX_THROW("Invalid size " + std::to_string(nbytes) + " at offset " +
+                       std::to_string(offset) + " for: " + filename);
+    is.seekg(offset, std::ios::beg);
 
-    T buffer(size, 0);
-    if(not is.read(&buffer[0], size))
+    T buffer(nbytes, 0);
+    if(not is.read(&buffer[0], nbytes))
         MIGRAPHX_THROW("Error reading file: " + filename);
     return buffer;
 }
 
-std::vector<char> read_buffer(const std::string& filename)
+std::vector<char> read_buffer(const std::string& filename, std::size_t offset, std::size_t nbytes)
 {
-    return generic_read_file<std::vector<char>>(filename);
+    return generic_read_file<std::vector<char>>(filename, offset, nbytes);
 }
 
 std::string read_string(const std::string& filename)
@@ -29,6 +29,7 @@
 #include <migraphx/config.hpp>
 #include <migraphx/make_shared_array.hpp>
 #include <functional>
+#include <memory>
 #include <utility>
 
 // clang-format off
@@ -53,7 +54,9 @@ struct argument : raw_data<argument>
         : m_shape(std::move(s))
 
     {
-        assign_buffer([f = std::move(d)]() mutable { return reinterpret_cast<char*>(f()); });
+        // The function may own its buffer, so copies of the argument copy it
+        assign_buffer([f = std::move(d)]() mutable { return reinterpret_cast<char*>(f()); },
+                      false);
     }
     template <class T>
     argument(shape s, T* d)
@@ -94,10 +97,20 @@ struct argument : raw_data<argument>
     argument element(std::size_t i) const;
 
     private:
-    void assign_buffer(std::function<char*()> d);
+    void assign_buffer(std::function<char*()> d, bool shared = true);
     struct data_t
     {
-        std::function<char*()> get = nullptr;
+        data_t() = default;
+        data_t(std::function<char*()> f, bool s);
+        data_t(const data_t& d);
+        data_t(data_t&&) = default;
+        data_t& operator=(const data_t& d);
+        data_t& operator=(data_t&&) = default;
+        ~data_t() = default;
+        // When shared, copies point at the same function so copying an
+        // argument doesn't allocate
+        std::shared_ptr<std::function<char*()>> get = nullptr;
+        bool shared = true;
         std::vector<data_t> sub = {};
         data_t share() const;
         static data_t from_args(const std::vector<argument>& args);
@@ -32,6 +32,8 @@ inline namespace MIGRAPHX_INLINE_NS {
 struct assignment_options
 {
     support_metric metric = support_metric::latency;
+    // Cost of moving one byte between two targets, in the same units as the segment metric
+    float transfer_cost = 1.0f / (1 << 20);
 };
 
 } // namespace MIGRAPHX_INLINE_NS
@@ -0,0 +1,81 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_COMPILE_CACHE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_COMPILE_CACHE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/filesystem.hpp>
+#include <migraphx/optional.hpp>
+#include <atomic>
+#include <string>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/// Incrementally hash bytes into a stable hex key that can be used as a file name
+struct cache_key_builder
+{
+    cache_key_builder& add(const char* data, std::size_t n);
+    cache_key_builder& add(const std::string& s);
+    std::string str() const;
+
+    private:
+    std::uint64_t h1 = 14695981039346656037ULL;
+    std::uint64_t h2 = 0x9e3779b97f4a7c15ULL;
+};
+
+/// A content addressed cache of compiled binaries stored on disk. Entries are
+/// published with an atomic rename so several processes can share the same
+/// directory, and the least recently used entries are removed once the
+/// directory grows past `max_size` bytes.
+struct compile_cache
+{
+    compile_cache(fs::path d, std::size_t max);
+
+    compile_cache(const compile_cache&) = delete;
+    compile_cache& operator=(const compile_cache&) = delete;
+
+    optional<std::vector<char>> lookup(const std::string& key);
+    void store(const std::string& key, const std::vector<char>& data);
+    /// Remove least recently used entries until the cache fits in `max_size`
+    void evict() const;
+    /// Total size in bytes of the entries on disk
+    std::size_t size() const;
+
+    fs::path path(const std::string& key) const;
+
+    fs::path dir;
+    std::size_t max_size;
+    std::atomic<std::size_t> hits{0};
+    std::atomic<std::size_t> misses{0};
+};
+
+/// The process wide cache configured by MIGRAPHX_COMPILE_CACHE_DIR and
+/// MIGRAPHX_COMPILE_CACHE_SIZE, or nullptr when caching is disabled
+compile_cache* get_compile_cache();
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+#endif // MIGRAPHX_GUARD_MIGRAPHX_COMPILE_CACHE_HPP
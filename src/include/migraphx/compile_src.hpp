@@ -26,6 +26,7 @@
 
 #include <migraphx/config.hpp>
 #include <migraphx/filesystem.hpp>
+#include <migraphx/job_server.hpp>
 #include <functional>
 #include <string>
 #include <utility>
@@ -50,8 +51,21 @@ struct src_compiler
     std::string out_ext                       = ".o";
     std::function<fs::path(fs::path)> process = nullptr;
     std::vector<char> compile(const std::vector<src_file>& srcs) const;
+    /// Key identifying the output of `compile`, based on the sources, flags
+    /// and compiler version
+    std::string cache_key(const std::vector<src_file>& srcs) const;
 };
 
+struct src_compile_job
+{
+    src_compiler compiler;
+    std::vector<src_file> srcs;
+};
+
+/// Compile a batch of sources, running up to `js.workers` compilers at once
+std::vector<std::vector<char>> compile_all(const std::vector<src_compile_job>& jobs,
+                                           const job_server& js = job_server{});
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
 #endif // MIGRAPHX_GUARD_MIGRAPHX_COMPILE_SRC_HPP
@@ -0,0 +1,74 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_EVAL_PLAN_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_EVAL_PLAN_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/argument.hpp>
+#include <migraphx/instruction_ref.hpp>
+#include <migraphx/operation.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct module;
+
+/// An instruction prepared for evaluation: the operator is normalized and
+/// copied once, literals are materialized, and inputs refer to the result
+/// slots of earlier steps
+struct eval_step
+{
+    enum kind_t
+    {
+        constant,
+        parameter,
+        returns,
+        compute
+    };
+    kind_t kind = compute;
+    instruction_ref ins;
+    operation op      = {};
+    argument value    = {};
+    std::string param = {};
+    /// Slot of each input, or `outer` when it comes from an enclosing module
+    std::vector<std::size_t> inputs = {};
+
+    static constexpr std::size_t outer = -1;
+};
+
+/// The steps for evaluating a finalized module, in instruction order
+struct eval_plan
+{
+    std::vector<eval_step> steps;
+    std::unordered_map<instruction_ref, std::size_t> slots;
+};
+
+eval_plan make_eval_plan(const module& m);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+#endif // MIGRAPHX_GUARD_MIGRAPHX_EVAL_PLAN_HPP
@@ -28,6 +28,11 @@
 #include <migraphx/literal.hpp>
 #include <migraphx/type_traits.hpp>
 #include <migraphx/config.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/rank.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <random>
 
 namespace migraphx {
@@ -108,19 +113,142 @@ struct xorshift_generator
     }
 };
 
+// Counter-based generator in the style of Philox-2x32-10. Each value only depends on the seed and
+// the counter, so it can be used to split generation across threads.
+struct philox_generator
+{
+    std::uint32_t key;
+    std::uint64_t offset;
+
+    philox_generator(unsigned long seed = 0)
+        : key(static_cast<std::uint32_t>(seed)), offset(seed & 0xFFFFFFFF00000000ULL)
+    {
+    }
+
+    constexpr std::uint64_t operator()(std::uint64_t counter) const noexcept
+    {
+        counter ^= offset;
+        auto lo = static_cast<std::uint32_t>(counter);
+        auto hi = static_cast<std::uint32_t>(counter >> 32U);
+        auto k  = key;
+        for(int round = 0; round < 10; round++)
+        {
+            const std::uint64_t product = std::uint64_t{0xD256D193} * lo;
+            const auto next             = static_cast<std::uint32_t>(product >> 32U) ^ hi ^ k;
+            hi                          = static_cast<std::uint32_t>(product);
+            lo                          = next;
+            k += 0x9E3779B9;
+        }
+        return (std::uint64_t{lo} << 32U) | hi;
+    }
+};
+
+// Independent xorshf96 streams that are stepped together, so the shifts are vectorized. The
+// streams of each block are seeded with the counter-based generator from the block index.
+struct xorshf96_lanes
+{
+    static constexpr std::size_t lanes = 64;
+
+    std::array<std::uint64_t, lanes> x;
+    std::array<std::uint64_t, lanes> y;
+    std::array<std::uint64_t, lanes> z;
+
+    xorshf96_lanes(const philox_generator& gen, std::uint64_t block)
+    {
+        const std::uint64_t start = block * lanes * 3;
+        for(std::size_t j = 0; j < lanes; j++)
+        {
+            // The state can't be all zeros
+            x[j] = gen(start + j) | 1U;
+            y[j] = gen(start + lanes + j);
+            z[j] = gen(start + 2 * lanes + j);
+        }
+    }
+
+    void operator()(std::array<std::uint64_t, lanes>& result) noexcept
+    {
+        for(std::size_t j = 0; j < lanes; j++)
+        {
+            auto t = x[j];
+            t ^= t << 16U;
+            t ^= t >> 5U;
+            t ^= t << 1U;
+            x[j]      = y[j];
+            y[j]      = z[j];
+            z[j]      = t ^ x[j] ^ y[j];
+            result[j] = z[j];
+        }
+    }
+};
+
+// For these types, normalize only depends on the lowest 5 bits (or on whether the value is zero),
+// so a table is cheaper than normalize, especially for half
+template <class T>
+struct normalize_table
+{
+    std::array<T, 32> values;
+    T zero;
+
+    normalize_table() : zero(normalize<T>(0))
+    {
+        for(std::size_t i = 0; i < values.size(); i++)
+            values[i] = normalize<T>(i + values.size());
+    }
+
+    T operator()(std::uint64_t z) const { return z == 0 ? zero : values[z % values.size()]; }
+};
+
+template <class T, MIGRAPHX_REQUIRES(is_floating_point<T>{} or sizeof(T) == 1)>
+auto make_normalize(rank<1>)
+{
+    return normalize_table<T>{};
+}
+
+template <class T>
+auto make_normalize(rank<0>)
+{
+    return [](std::uint64_t z) { return normalize<T>(z); };
+}
+
+// The data is generated in fixed size blocks, so the result for a seed doesn't depend on the
+// number of threads
+template <class T>
+void generate_tensor_values(T* data, std::size_t n, unsigned long seed = 0)
+{
+    const philox_generator gen{seed};
+    const auto norm              = make_normalize<T>(rank<1>{});
+    const std::size_t block_size = 1UL << 16U;
+    par_for((n + block_size - 1) / block_size, 1, [&](std::size_t block) {
+        xorshf96_lanes streams{gen, block};
+        std::array<std::uint64_t, xorshf96_lanes::lanes> z;
+        const std::size_t last = std::min(n, (block + 1) * block_size);
+        for(std::size_t i = block * block_size; i < last; i += z.size())
+        {
+            streams(z);
+            std::transform(z.begin(), z.begin() + std::min(z.size(), last - i), data + i, norm);
+        }
+    });
+}
+
 template <class T>
 auto generate_tensor_data(const migraphx::shape& s, unsigned long seed = 0)
 {
-    auto result = make_shared_array<T>(s.element_space());
-    std::generate(result.get(), result.get() + s.element_space(), xorshf96_generator<T>{seed});
+    // Every element is written, so skip the zero initialization of make_shared_array
+    std::shared_ptr<T> result(new T[s.element_space()], std::default_delete<T[]>()); // NOLINT
+    generate_tensor_values(result.get(), s.element_space(), seed);
     return result;
 }
 
 template <class T>
 auto fill_tensor_data(const migraphx::shape& s, unsigned long value = 0)
 {
-    auto result = make_shared_array<T>(s.element_space());
-    std::generate(result.get(), result.get() + s.element_space(), [=] { return value; });
+    const std::size_t n = s.element_space();
+    std::shared_ptr<T> result(new T[n], std::default_delete<T[]>()); // NOLINT
+    const std::size_t block_size = 1UL << 18U;
+    par_for((n + block_size - 1) / block_size, 1, [&](std::size_t block) {
+        auto* first = result.get() + block * block_size;
+        std::fill(first, result.get() + std::min(n, (block + 1) * block_size), T(value));
+    });
     return result;
 }
 
@@ -74,6 +74,9 @@ struct instruction
 
     const operation& get_operator() const;
 
+    /// Hash of the operator, computed once and kept until the operator is replaced
+    std::size_t get_operator_hash() const;
+
     std::string name() const;
 
     const std::vector<instruction_ref>& inputs() const;
@@ -170,7 +173,8 @@ struct instruction
     std::vector<instruction_ref> arguments;
     std::vector<module_ref> module_args;
     literal lit;
-    bool normalized = false;
+    bool normalized             = false;
+    mutable std::size_t op_hash = 0;
 };
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
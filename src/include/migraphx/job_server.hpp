@@ -0,0 +1,52 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_JOB_SERVER_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_JOB_SERVER_HPP
+
+#include <migraphx/config.hpp>
+#include <cstddef>
+#include <functional>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/// Runs a batch of independent jobs, such as external compiles, on a bounded
+/// number of worker threads. The first exception thrown by a job stops any
+/// further jobs from starting and is rethrown once the running ones finish.
+struct job_server
+{
+    /// Use `n` workers, or MIGRAPHX_COMPILE_JOBS (defaulting to the number of
+    /// hardware threads) when `n` is zero
+    explicit job_server(std::size_t n = 0);
+
+    std::size_t workers = 1;
+    /// Called with the number of finished jobs and the total after each job
+    std::function<void(std::size_t, std::size_t)> progress = nullptr;
+
+    void run(std::size_t n, const std::function<void(std::size_t)>& f) const;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+#endif // MIGRAPHX_GUARD_MIGRAPHX_JOB_SERVER_HPP
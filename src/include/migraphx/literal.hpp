@@ -86,6 +86,14 @@ struct literal : raw_data<literal>
         std::copy(x, x + s.bytes(), buffer.get());
     }
 
+    /// Takes the data of the argument without copying it. The literal keeps the whole buffer of
+    /// the argument alive, so it shouldn't be a view into a larger buffer.
+    explicit literal(const argument& a) : m_shape(a.get_shape())
+    {
+        auto owner = std::make_shared<argument>(a.share());
+        buffer     = std::shared_ptr<char>(owner, owner->data());
+    }
+
     /// Whether data is available
     bool empty() const { return this->buffer == nullptr; }
 
@@ -100,7 +108,7 @@ struct literal : raw_data<literal>
     argument get_argument() const
     {
         auto b = make_shared_array<char>(buffer.get(), buffer.get() + m_shape.bytes());
-        return {m_shape, [b]() { return b.get(); }};
+        return {m_shape, b};
     }
 
     private:
@@ -45,6 +45,7 @@ inline namespace MIGRAPHX_INLINE_NS {
 const operation& get_operation(instruction_ref ins);
 
 struct module_impl;
+struct eval_plan;
 
 using parameter_map = std::unordered_map<std::string, argument>;
 using ins_dep_map   = std::unordered_map<instruction_ref, std::unordered_set<instruction_ref>>;
@@ -188,6 +189,9 @@ struct module
     instruction_ref find_dangling_reference() const;
 
     void finalize(context& ctx);
+    /// The evaluation plan built by finalize, or nullptr if the module
+    /// changed since
+    const eval_plan* get_eval_plan() const;
 
     void debug_print() const;
     void debug_print(instruction_ref ins) const;
@@ -115,8 +115,11 @@ struct concat
             visit_all(result, argl)([&](auto output, auto input) {
                 auto slice_shape =
                     shape{output_shape.type(), input.get_shape().lens(), output_shape.strides()};
-                auto slice = make_view(slice_shape, output.data() + coffsets[l]);
-                std::copy(input.begin(), input.end(), slice.begin());
+                auto* slice                 = output.data() + coffsets[l];
+                std::array<shape, 2> shapes = {slice_shape, input.get_shape()};
+                shape_for_each_offset(shapes, [&](const auto& offsets) {
+                    slice[offsets[0]] = input.data()[offsets[1]];
+                });
             });
         }
         return result;
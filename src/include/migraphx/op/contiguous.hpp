@@ -28,6 +28,7 @@
 #include <migraphx/argument.hpp>
 #include <migraphx/shape_for_each.hpp>
 #include <migraphx/config.hpp>
+#include <array>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -56,8 +57,9 @@ struct contiguous
         assert(output_shape.standard());
         argument result{output_shape};
         visit_all(result, args[0])([&](auto output, auto input) {
-            shape_for_each(output.get_shape(), [&](const auto& idx) {
-                output(idx.begin(), idx.end()) = input(idx.begin(), idx.end());
+            std::array<shape, 2> shapes = {output.get_shape(), input.get_shape()};
+            shape_for_each_offset(shapes, [&](const auto& offsets) {
+                output.data()[offsets[0]] = input.data()[offsets[1]];
             });
         });
         return result;
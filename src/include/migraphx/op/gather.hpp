@@ -100,13 +100,22 @@ struct gather
                     auto out_lens  = data.get_shape().lens();
                     out_lens[axis] = indices.get_shape().elements();
                     migraphx::shape out_comp_shape{data.get_shape().type(), out_lens};
-                    shape_for_each(out_comp_shape, [&](const auto& out_idx) {
-                        auto data_idx  = out_idx;
-                        auto in_index  = indices[data_idx[axis]];
-                        in_index       = (in_index < 0) ? in_index + axis_dim_size : in_index;
-                        data_idx[axis] = in_index;
-                        output[out_comp_shape.index(out_idx.begin(), out_idx.end())] =
-                            data(data_idx.begin(), data_idx.end());
+                    // The data is iterated without the axis, which is added from the indices,
+                    // and the third shape gives the position in the indices
+                    auto data_strides  = data.get_shape().strides();
+                    auto axis_stride   = data_strides[axis];
+                    data_strides[axis] = 0;
+                    std::vector<std::size_t> index_strides(out_lens.size(), 0);
+                    index_strides[axis]         = 1;
+                    std::array<shape, 3> shapes = {
+                        out_comp_shape,
+                        shape{out_comp_shape.type(), out_lens, data_strides},
+                        shape{out_comp_shape.type(), out_lens, index_strides}};
+                    shape_for_each_offset(shapes, [&](const auto& offsets) {
+                        auto in_index = indices[offsets[2]];
+                        in_index      = (in_index < 0) ? in_index + axis_dim_size : in_index;
+                        output[offsets[0]] =
+                            data.data()[offsets[1] + std::size_t(in_index) * axis_stride];
                     });
                 }
             });
@@ -25,17 +25,16 @@
 #define MIGRAPHX_GUARD_OPERATORS_NONMAXSUPPRESSION_HPP
 
 #include <cmath>
-#include <queue>
 #include <cstdint>
 #include <iterator>
+#include <vector>
 #include <migraphx/config.hpp>
 #include <migraphx/ranges.hpp>
 #include <migraphx/float_equal.hpp>
 #include <migraphx/algorithm.hpp>
 #include <migraphx/tensor_view.hpp>
-#include <migraphx/shape_for_each.hpp>
+#include <migraphx/par_for.hpp>
 #include <migraphx/check_shapes.hpp>
-#include <migraphx/output_iterator.hpp>
 #include <migraphx/argument.hpp>
 
 namespace migraphx {
@@ -180,67 +179,121 @@ struct nonmaxsuppression
         return result;
     }
 
-    inline bool suppress_by_iou(box b1, box b2, double iou_threshold) const
+    // Boxes of a batch stored as structure of arrays with the corners sorted and the areas
+    // precomputed, so the IoU against a set of boxes can be computed with a vectorized loop
+    struct box_set
     {
-        b1.sort();
-        b2.sort();
+        std::vector<double> x0;
+        std::vector<double> x1;
+        std::vector<double> y0;
+        std::vector<double> y1;
+        std::vector<double> area;
 
-        box intersection{};
-        for(auto i : range(2))
+        void resize(std::size_t n)
         {
-            intersection[i][0] = std::max(b1[i][0], b2[i][0]);
-            intersection[i][1] = std::min(b1[i][1], b2[i][1]);
+            x0.resize(n);
+            x1.resize(n);
+            y0.resize(n);
+            y1.resize(n);
+            area.resize(n);
         }
 
-        std::vector<std::array<double, 2>> bbox = {intersection.x, intersection.y};
-        if(std::any_of(bbox.begin(), bbox.end(), [](auto bx) {
-               return not std::is_sorted(bx.begin(), bx.end());
-           }))
+        void reserve(std::size_t n)
         {
-            return false;
+            x0.reserve(n);
+            x1.reserve(n);
+            y0.reserve(n);
+            y1.reserve(n);
+            area.reserve(n);
+        }
+
+        void clear()
+        {
+            x0.clear();
+            x1.clear();
+            y0.clear();
+            y1.clear();
+            area.clear();
         }
 
-        const double area1             = b1.area();
-        const double area2             = b2.area();
-        const double intersection_area = intersection.area();
-        const double union_area        = area1 + area2 - intersection_area;
+        std::size_t size() const { return area.size(); }
 
-        if(area1 <= .0f or area2 <= .0f or union_area <= .0f)
+        void set(std::size_t i, box b)
         {
-            return false;
+            b.sort();
+            x0[i]   = b.x[0];
+            x1[i]   = b.x[1];
+            y0[i]   = b.y[0];
+            y1[i]   = b.y[1];
+            area[i] = b.area();
         }
 
-        const double intersection_over_union = intersection_area / union_area;
+        void push_back(const box_set& bs, std::size_t i)
+        {
+            x0.push_back(bs.x0[i]);
+            x1.push_back(bs.x1[i]);
+            y0.push_back(bs.y0[i]);
+            y1.push_back(bs.y1[i]);
+            area.push_back(bs.area[i]);
+        }
+    };
 
-        return intersection_over_union > iou_threshold;
+    // Check if the box i from bs overlaps any of the selected boxes by more than the iou_threshold
+    static bool
+    suppress_by_iou(const box_set& bs, std::size_t i, const box_set& selected, double iou_threshold)
+    {
+        const double bx0   = bs.x0[i];
+        const double bx1   = bs.x1[i];
+        const double by0   = bs.y0[i];
+        const double by1   = bs.y1[i];
+        const double barea = bs.area[i];
+        if(barea <= 0.0)
+            return false;
+        const std::size_t n = selected.size();
+        // Process the selected boxes in blocks without branches in the inner loop so it can be
+        // vectorized, exit early between blocks
+        const std::size_t block = 16;
+        for(std::size_t start = 0; start < n; start += block)
+        {
+            const std::size_t last = std::min(n, start + block);
+            bool suppress          = false;
+            for(std::size_t j = start; j < last; j++)
+            {
+                const double w     = std::min(bx1, selected.x1[j]) - std::max(bx0, selected.x0[j]);
+                const double h     = std::min(by1, selected.y1[j]) - std::max(by0, selected.y0[j]);
+                const double inter = w * h;
+                const double uarea = barea + selected.area[j] - inter;
+                const bool overlap =
+                    (w >= 0.0) & (h >= 0.0) & (selected.area[j] > 0.0) & (uarea > 0.0);
+                suppress |= overlap & (inter / uarea > iou_threshold);
+            }
+            if(suppress)
+                return true;
+        }
+        return false;
     }
 
-    // filter boxes below score_threshold
+    // filter boxes below score_threshold into a max heap of [score, index]
     template <class T>
-    std::priority_queue<std::pair<double, int64_t>>
-    filter_boxes_by_score(T scores_start, std::size_t num_boxes, double score_threshold) const
+    void filter_boxes_by_score(std::vector<std::pair<double, int64_t>>& boxes_heap,
+                               T scores_start,
+                               std::size_t num_boxes,
+                               double score_threshold) const
     {
-        std::priority_queue<std::pair<double, int64_t>> boxes_heap;
-        auto insert_to_boxes_heap =
-            make_function_output_iterator([&](const auto& x) { boxes_heap.push(x); });
-        int64_t box_idx = 0;
-        transform_if(
-            scores_start,
-            scores_start + num_boxes,
-            insert_to_boxes_heap,
-            [&](auto sc) {
-                box_idx++;
-                return sc >= score_threshold;
-            },
-            [&](auto sc) { return std::make_pair(sc, box_idx - 1); });
-        return boxes_heap;
+        boxes_heap.clear();
+        for(std::size_t i = 0; i < num_boxes; i++)
+        {
+            double sc = scores_start[i];
+            if(sc >= score_threshold)
+                boxes_heap.emplace_back(sc, i);
+        }
+        std::make_heap(boxes_heap.begin(), boxes_heap.end());
     }
 
     template <class Output, class Boxes, class Scores>
     std::size_t compute_nms(Output output,
                             Boxes boxes,
                             Scores scores,
-                            const shape& max_output_shape,
                             std::size_t max_output_boxes_per_class,
                             double iou_threshold,
                             double score_threshold) const
@@ -250,50 +303,54 @@ struct nonmaxsuppression
         const auto num_batches = lens[0];
         const auto num_classes = lens[1];
         const auto num_boxes   = lens[2];
-        // boxes of a class with NMS applied [score, index]
-        std::vector<std::pair<double, int64_t>> selected_boxes_inside_class;
-        std::vector<int64_t> selected_indices;
-        selected_boxes_inside_class.reserve(max_output_shape.elements());
-        // iterate over batches and classes
-        shape comp_s{shape::double_type, {num_batches, num_classes}};
-        shape_for_each(comp_s, [&](auto idx) {
-            auto batch_idx = idx[0];
-            auto class_idx = idx[1];
-            // index offset for this class
-            auto scores_start = scores.begin() + (batch_idx * num_classes + class_idx) * num_boxes;
-            // iterator to first value of this batch
+
+        // Normalize the boxes and compute the areas once since they are shared by all classes
+        std::vector<box_set> batches(num_batches);
+        std::for_each(batches.begin(), batches.end(), [&](auto& bs) { bs.resize(num_boxes); });
+        par_for(num_batches * num_boxes, [&](auto i) {
+            auto batch_idx = i / num_boxes;
+            auto box_idx   = i % num_boxes;
             auto batch_boxes_start = boxes.begin() + batch_idx * num_boxes * 4;
-            auto boxes_heap = filter_boxes_by_score(scores_start, num_boxes, score_threshold);
-            selected_boxes_inside_class.clear();
+            batches[batch_idx].set(box_idx, batch_box(batch_boxes_start, box_idx));
+        });
+
+        // Each (batch, class) slice is independent so they are computed in parallel, and then
+        // concatenated in order so the output is the same as computing them serially
+        std::vector<std::vector<int64_t>> selected_indices(num_batches * num_classes);
+        par_for(num_batches * num_classes, 1, [&](auto slice) {
+            auto batch_idx = slice / num_classes;
+            auto class_idx = slice % num_classes;
+            const auto& bs = batches[batch_idx];
+            // index offset for this class
+            auto scores_start = scores.begin() + slice * num_boxes;
+            std::vector<std::pair<double, int64_t>> boxes_heap;
+            boxes_heap.reserve(num_boxes);
+            filter_boxes_by_score(boxes_heap, scores_start, num_boxes, score_threshold);
+            // boxes of a class with NMS applied
+            box_set selected;
+            selected.reserve(std::min(max_output_boxes_per_class, boxes_heap.size()));
+            auto& indices = selected_indices[slice];
             // Get the next box with top score, filter by iou_threshold
-            while(not boxes_heap.empty() &&
-                  selected_boxes_inside_class.size() < max_output_boxes_per_class)
+            while(not boxes_heap.empty() and selected.size() < max_output_boxes_per_class)
             {
+                std::pop_heap(boxes_heap.begin(), boxes_heap.end());
+                const auto box_idx = boxes_heap.back().second;
+                boxes_heap.pop_back();
                 // Check with existing selected boxes for this class, remove box if it
                 // exceeds the IOU (Intersection Over Union) threshold
-                const auto next_top_score = boxes_heap.top();
-                bool not_selected =
-                    std::any_of(selected_boxes_inside_class.begin(),
-                                selected_boxes_inside_class.end(),
-                                [&](auto selected_index) {
-                                    return this->suppress_by_iou(
-                                        batch_box(batch_boxes_start, next_top_score.second),
-                                        batch_box(batch_boxes_start, selected_index.second),
-                                        iou_threshold);
-                                });
-
-                if(not not_selected)
-                {
-                    selected_boxes_inside_class.push_back(next_top_score);
-                    selected_indices.push_back(batch_idx);
-                    selected_indices.push_back(class_idx);
-                    selected_indices.push_back(next_top_score.second);
-                }
-                boxes_heap.pop();
+                if(suppress_by_iou(bs, box_idx, selected, iou_threshold))
+                    continue;
+                selected.push_back(bs, box_idx);
+                indices.push_back(batch_idx);
+                indices.push_back(class_idx);
+                indices.push_back(box_idx);
             }
         });
-        std::copy(selected_indices.begin(), selected_indices.end(), output.begin());
-        return selected_indices.size() / 3;
+
+        auto out = output.begin();
+        for(const auto& indices : selected_indices)
+            out = std::copy(indices.begin(), indices.end(), out);
+        return std::distance(output.begin(), out) / 3;
     }
 
     argument compute(const shape& output_shape, std::vector<argument> args) const
@@ -317,7 +374,6 @@ struct nonmaxsuppression
                 num_selected = compute_nms(output,
                                            boxes,
                                            scores,
-                                           max_output_shape,
                                            max_output_boxes_per_class,
                                            iou_threshold,
                                            score_threshold);
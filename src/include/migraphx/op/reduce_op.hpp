@@ -30,9 +30,12 @@
 #include <migraphx/tensor_view.hpp>
 #include <migraphx/shape_for_each.hpp>
 #include <migraphx/par_for.hpp>
+#include <migraphx/reduce_dims.hpp>
 #include <migraphx/config.hpp>
 #include <migraphx/value.hpp>
 #include <migraphx/op/normalize_attribute.hpp>
+#include <array>
+#include <numeric>
 #include <vector>
 
 namespace migraphx {
@@ -151,6 +154,152 @@ struct reduce_op : op_name<Derived>
             static_cast<const Derived&>(*this).output(batch_shape)(val);
     }
 
+    // Number of contiguous elements reduced with lanes before the range is split in half
+    static constexpr std::size_t pairwise_size = 256;
+    // Number of rows accumulated into a block of columns before the rows are split in half
+    static constexpr std::size_t pairwise_rows = 64;
+    // Number of inner elements accumulated together when the reduced axis is not innermost
+    static constexpr std::size_t column_block = 64;
+    // Minimum number of elements reduced by one parallel task
+    static constexpr std::size_t min_task_size = 8192;
+
+    // Reduce n contiguous elements. Independent lanes let the loop vectorize, and longer
+    // ranges are split in half recursively so the accumulation is pairwise.
+    template <class T>
+    accumulator_type<T> reduce_contiguous(const T* x, std::size_t n) const
+    {
+        using accumulator = accumulator_type<T>;
+        auto& self        = static_cast<const Derived&>(*this);
+        if(n > pairwise_size)
+        {
+            std::size_t half = n / 2;
+            return self.op()(reduce_contiguous(x, half), reduce_contiguous(x + half, n - half));
+        }
+        constexpr std::size_t lanes = 8;
+        std::array<accumulator, lanes> acc;
+        acc.fill(self.init());
+        std::size_t i = 0;
+        for(; i + lanes <= n; i += lanes)
+        {
+            for(std::size_t l = 0; l < lanes; l++)
+            {
+                accumulator v = x[i + l];
+                acc[l]        = self.op()(accumulator{self.input()(v)}, acc[l]);
+            }
+        }
+        for(; i < n; i++)
+        {
+            accumulator v = x[i];
+            acc[0]        = self.op()(accumulator{self.input()(v)}, acc[0]);
+        }
+        return std::accumulate(acc.begin() + 1, acc.end(), acc.front(), self.op());
+    }
+
+    // Accumulate n rows of w consecutive elements, stride apart, into acc. Each row is read
+    // contiguously so the loop vectorizes, and the rows are split in half recursively.
+    template <class T>
+    void reduce_columns(const T* x,
+                        std::size_t n,
+                        std::size_t stride,
+                        std::size_t w,
+                        accumulator_type<T>* acc) const
+    {
+        using accumulator = accumulator_type<T>;
+        auto& self        = static_cast<const Derived&>(*this);
+        if(n > pairwise_rows)
+        {
+            std::size_t half = n / 2;
+            std::array<accumulator, column_block> right;
+            std::fill(right.begin(), right.begin() + w, accumulator(self.init()));
+            reduce_columns(x, half, stride, w, acc);
+            reduce_columns(x + half * stride, n - half, stride, w, right.data());
+            for(std::size_t i = 0; i < w; i++)
+                acc[i] = self.op()(acc[i], right[i]);
+            return;
+        }
+        for(std::size_t r = 0; r < n; r++)
+        {
+            const T* row = x + r * stride;
+            for(std::size_t i = 0; i < w; i++)
+            {
+                accumulator v = row[i];
+                acc[i]        = self.op()(accumulator{self.input()(v)}, acc[i]);
+            }
+        }
+    }
+
+    // Reduce a standard input viewed as (outer, n, inner) into an output viewed as (outer,
+    // inner). When there are fewer outputs than threads, the reduced dimension is split into
+    // chunks that are reduced in parallel and then combined.
+    template <class T>
+    void reduce_standard(const T* x,
+                         T* out,
+                         std::size_t outer,
+                         std::size_t n,
+                         std::size_t inner,
+                         const shape& batch_shape) const
+    {
+        using accumulator   = accumulator_type<T>;
+        auto& self          = static_cast<const Derived&>(*this);
+        auto finish         = self.output(batch_shape);
+        std::size_t width   = std::min(inner, column_block);
+        std::size_t blocks  = (inner + width - 1) / width;
+        std::size_t tasks   = outer * blocks;
+        std::size_t threads = std::thread::hardware_concurrency();
+        std::size_t splits  = 1;
+        if(tasks < threads)
+            splits = std::max<std::size_t>(
+                1, std::min((threads + tasks - 1) / tasks, n * width / min_task_size));
+        std::size_t chunk = (n + splits - 1) / splits;
+        splits            = (n + chunk - 1) / chunk;
+        std::vector<accumulator> partial(splits > 1 ? tasks * splits * width : 0);
+        std::size_t grain = std::max<std::size_t>(1, min_task_size / (chunk * width));
+        auto run          = [&](std::size_t t, accumulator* acc) {
+            std::size_t task  = t / splits;
+            std::size_t first = (t % splits) * chunk;
+            std::size_t len   = std::min(chunk, n - first);
+            std::size_t o     = task / blocks;
+            std::size_t col   = (task % blocks) * width;
+            std::size_t w     = std::min(width, inner - col);
+            const T* base     = x + (o * n + first) * inner + col;
+            if(inner == 1)
+            {
+                acc[0] = reduce_contiguous(base, len);
+                return;
+            }
+            std::fill(acc, acc + w, accumulator(self.init()));
+            reduce_columns(base, len, inner, w, acc);
+        };
+        auto write = [&](std::size_t task, const accumulator* acc) {
+            std::size_t o   = task / blocks;
+            std::size_t col = (task % blocks) * width;
+            std::size_t w   = std::min(width, inner - col);
+            for(std::size_t i = 0; i < w; i++)
+                out[o * inner + col + i] = finish(acc[i]);
+        };
+        if(splits == 1)
+        {
+            par_for(tasks, grain, [&](auto t) {
+                std::array<accumulator, column_block> acc;
+                run(t, acc.data());
+                write(t, acc.data());
+            });
+            return;
+        }
+        par_for(tasks * splits, 1, [&](auto t) { run(t, partial.data() + t * width); });
+        for(std::size_t task = 0; task < tasks; task++)
+        {
+            accumulator* acc = partial.data() + task * splits * width;
+            for(std::size_t s = 1; s < splits; s++)
+            {
+                const accumulator* next = acc + s * width;
+                for(std::size_t i = 0; i < width; i++)
+                    acc[i] = self.op()(acc[i], next[i]);
+            }
+            write(task, acc);
+        }
+    }
+
     argument compute(const shape& output_shape, std::vector<argument> args) const
     {
         argument result{output_shape};
@@ -159,6 +308,36 @@ struct reduce_op : op_name<Derived>
         std::vector<std::size_t> batch_lens(output_shape.lens().size(), 1);
         tune_dims(tuned_axes, arg_lens, batch_lens);
         shape batch_shape{output_shape.type(), batch_lens};
+
+        // Merge the dimensions so the reduced axes collapse into one: if the input is standard
+        // and there is then a single reduced dimension, reduce it as (outer, reduce, inner)
+        const auto& in_s = args.front().get_shape();
+        if(in_s.standard() and output_shape.standard() and in_s.elements() > 0)
+        {
+            auto rshapes    = reduce_dims({output_shape, in_s});
+            const auto& out = rshapes.front().lens();
+            const auto& in  = rshapes.back().lens();
+            std::vector<std::size_t> reduced;
+            for(std::size_t i = 0; i < in.size(); i++)
+            {
+                if(out[i] != in[i])
+                    reduced.push_back(i);
+            }
+            if(reduced.size() <= 1)
+            {
+                std::size_t axis  = reduced.empty() ? in.size() : reduced.front();
+                std::size_t outer = std::accumulate(
+                    in.begin(), in.begin() + axis, std::size_t{1}, std::multiplies<>{});
+                std::size_t n     = reduced.empty() ? 1 : in[axis];
+                std::size_t inner = in_s.elements() / (outer * n);
+                visit_all(result, args[0])([&](auto output, auto input) {
+                    this->reduce_standard(
+                        input.data(), output.data(), outer, n, inner, batch_shape);
+                });
+                return result;
+            }
+        }
+
         visit_all(result, args[0])([&](auto output, auto input) {
             par_for(output_shape.elements(), [&](auto i) {
                 auto out_idx = output_shape.multi(i);
@@ -132,9 +132,14 @@ struct topk
                     auto idx2  = idx;
                     idx1[axis] = i1;
                     idx2[axis] = i2;
-                    return this->largest
-                               ? std::greater<>{}(input[in_s.index(idx1)], input[in_s.index(idx2)])
-                               : std::less<>{}(input[in_s.index(idx1)], input[in_s.index(idx2)]);
+                    auto x1    = input[in_s.index(idx1)];
+                    auto x2    = input[in_s.index(idx2)];
+                    if(this->largest ? x2 < x1 : x1 < x2)
+                        return true;
+                    if(this->largest ? x1 < x2 : x2 < x1)
+                        return false;
+                    // Equal values keep the lower index first, as onnx specifies
+                    return i1 < i2;
                 };
 
                 auto hp = this->make_heap(indices, comp);
@@ -80,6 +80,12 @@ struct operation
     /// An optional method to return which argument the output will alias. If
     /// there is no aliased output then -1 can be returned.
     std::ptrdiff_t output_alias(const std::vector<shape>& input) const;
+    /// An optional hash of the name and reflected members, consistent with equality. It does
+    /// not serialize the operation.
+    std::size_t hash() const;
+    /// An optional accessor returning the member with the given name, or a null value when
+    /// there is none, without serializing the other members.
+    value field(const std::string& key) const;
     /// An optional stream operator to print the operation. When this is not
     /// implemented, it will just print the operation's name.
     friend std::ostream& operator<<(std::ostream& os, const operation& op);
@@ -462,6 +468,40 @@ void from_value_op(T& x, const value& v)
     return migraphx::from_value(v, x);
 }
 
+template <class T>
+std::size_t hash_op(const T& x)
+{
+    std::size_t result = std::hash<std::string>{}(x.name());
+    hash_combine(result, reflect_hash(x));
+    return result;
+}
+
+template <class T>
+auto field_op(rank<1>, const T& x, const std::string& name) -> decltype(x.to_value())
+{
+    auto v = x.to_value();
+    if(not v.contains(name))
+        return {};
+    return v.at(name).without_key();
+}
+
+template <class T>
+value field_op(rank<0>, const T& x, const std::string& name)
+{
+    value result;
+    reflect_each(x, [&](auto&& y, auto&& field_name) {
+        if(field_name == name)
+            result = migraphx::to_value(y);
+    });
+    return result;
+}
+
+template <class T>
+value field_op(const T& x, const std::string& name)
+{
+    return field_op(rank<1>{}, x, name);
+}
+
 template <class T>
 lifetime get_lifetime_op(const T&)
 {
@@ -519,6 +559,10 @@ struct operation
     void from_value(const value& v);
     // (optional)
     value attributes() const;
+    // (optional)
+    std::size_t hash() const;
+    // (optional)
+    value field(const std::string& key) const;
     //
     friend std::ostream& operator<<(std::ostream& os, const operation& op);
     //
@@ -704,6 +748,18 @@ struct operation
         return (*this).private_detail_te_get_handle().attributes();
     }
 
+    std::size_t hash() const
+    {
+        assert((*this).private_detail_te_handle_mem_var);
+        return (*this).private_detail_te_get_handle().hash();
+    }
+
+    value field(const std::string& key) const
+    {
+        assert((*this).private_detail_te_handle_mem_var);
+        return (*this).private_detail_te_get_handle().field(key);
+    }
+
     friend std::ostream& operator<<(std::ostream& os, const operation& op)
     {
         assert(op.private_detail_te_handle_mem_var);
@@ -761,6 +817,8 @@ struct operation
         virtual value to_value() const                                                         = 0;
         virtual void from_value(const value& v)                                                = 0;
         virtual value attributes() const                                                       = 0;
+        virtual std::size_t hash() const                                                       = 0;
+        virtual value field(const std::string& key) const                                      = 0;
         virtual std::ostream& operator_shift_left(std::ostream& os) const                      = 0;
         virtual bool operator==(const operation& y) const                                      = 0;
     };
@@ -1051,6 +1109,34 @@ struct operation
         return detail::attributes_op(private_detail_te_self);
     }
 
+    template <class T>
+    static auto private_detail_te_default_hash(char, T&& private_detail_te_self)
+        -> decltype(private_detail_te_self.hash())
+    {
+        return private_detail_te_self.hash();
+    }
+
+    template <class T>
+    static std::size_t private_detail_te_default_hash(float, T&& private_detail_te_self)
+    {
+        return detail::hash_op(private_detail_te_self);
+    }
+
+    template <class T>
+    static auto
+    private_detail_te_default_field(char, T&& private_detail_te_self, const std::string& key)
+        -> decltype(private_detail_te_self.field(key))
+    {
+        return private_detail_te_self.field(key);
+    }
+
+    template <class T>
+    static value
+    private_detail_te_default_field(float, T&& private_detail_te_self, const std::string& key)
+    {
+        return detail::field_op(private_detail_te_self, key);
+    }
+
     template <typename PrivateDetailTypeErasedT>
     struct private_detail_te_handle_type : private_detail_te_handle_base_type
     {
@@ -1198,6 +1284,18 @@ struct operation
             return private_detail_te_default_attributes(char(0), private_detail_te_value);
         }
 
+        std::size_t hash() const override
+        {
+
+            return private_detail_te_default_hash(char(0), private_detail_te_value);
+        }
+
+        value field(const std::string& key) const override
+        {
+
+            return private_detail_te_default_field(char(0), private_detail_te_value, key);
+        }
+
         std::ostream& operator_shift_left(std::ostream& os) const override
         {
             using migraphx::detail::operation_operators::operator<<;
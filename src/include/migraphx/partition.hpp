@@ -0,0 +1,64 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_PARTITION_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_PARTITION_HPP
+
+#include <vector>
+#include <migraphx/config.hpp>
+#include <migraphx/target.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/instruction_ref.hpp>
+#include <migraphx/compile_options.hpp>
+#include <migraphx/assignment_options.hpp>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/// A run of instructions of a module copied into its own program. Parameter "i" of the program
+/// takes the value of inputs[i], and the program returns the values of outputs in order.
+struct module_partition
+{
+    program prog;
+    std::vector<instruction_ref> inputs;
+    std::vector<instruction_ref> outputs;
+};
+
+/// Copy the instructions, which must be in the order of the module, into a program. Literals are
+/// copied into the program, and the outputs are the instructions used after the run or the last
+/// instruction of the module.
+module_partition make_partition(const module& m, const std::vector<instruction_ref>& instructions);
+
+/// Compile the program across several targets. The instructions of the main module are assigned
+/// with program::get_target_assignments, and consecutive instructions on the same target form a
+/// partition that is compiled with that target. The program is replaced with one that runs the
+/// partitions in order and only copies data between targets at the partition boundaries.
+void compile_partitions(program& p,
+                        const std::vector<target>& targets,
+                        compile_options options       = compile_options{},
+                        assignment_options assignment = assignment_options{});
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHX_PARTITION_HPP
@@ -0,0 +1,80 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_PERF_COUNTERS_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_PERF_COUNTERS_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/instruction_ref.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct perf_counter_values
+{
+    std::uint64_t cycles       = 0;
+    std::uint64_t instructions = 0;
+    std::uint64_t cache_misses = 0;
+
+    perf_counter_values& operator+=(const perf_counter_values& x);
+
+    double ipc() const;
+    /// Bytes read from memory, estimated from the last level cache misses
+    double memory_bytes() const;
+};
+
+/// Hardware counters read with perf_event_open. One counter is opened for each thread of the
+/// process when they are created, so thread pools that already exist, such as the ones of OpenMP,
+/// are counted, and the threads created afterwards are counted through their parent. They are
+/// not available on other systems, or when the kernel doesn't allow them (see
+/// /proc/sys/kernel/perf_event_paranoid).
+struct perf_counters
+{
+    perf_counters();
+    perf_counters(const perf_counters&) = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+    ~perf_counters();
+
+    bool available() const;
+    /// Number of threads that have their own counters
+    std::size_t threads() const;
+
+    void start();
+    perf_counter_values stop();
+
+    private:
+    std::vector<int> fds;
+};
+
+/// Floating point operations of an instruction, estimated from its shapes
+double estimate_flops(instruction_ref ins);
+
+/// Bytes read and written by an instruction, estimated from its shapes
+double estimate_bytes(instruction_ref ins);
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHX_PERF_COUNTERS_HPP
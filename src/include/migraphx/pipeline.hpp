@@ -0,0 +1,104 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHX_PIPELINE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHX_PIPELINE_HPP
+
+#include <migraphx/config.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/target.hpp>
+#include <migraphx/compile_options.hpp>
+#include <iosfwd>
+#include <memory>
+#include <vector>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+struct pipeline_impl;
+
+struct pipeline_options
+{
+    /// Number of stages when the cut points are chosen automatically
+    std::size_t stages = 2;
+    /// Indices of the main module instructions, as numbered when the program is printed, that
+    /// start a new stage. When empty, the stages are cut so each has about the same estimated
+    /// work.
+    std::vector<std::size_t> cut_points = {};
+    /// Micro batches that can wait between two stages before the earlier stage blocks
+    std::size_t queue_size = 2;
+    /// Threads given to each stage, or 0 to divide the cores evenly between the stages
+    std::size_t threads_per_stage = 0;
+    /// Pin the threads of each stage to their own cores. Only supported on linux.
+    bool pin_threads = true;
+};
+
+struct pipeline_stage_report
+{
+    std::size_t instructions = 0;
+    std::size_t threads      = 0;
+    std::size_t batches      = 0;
+    /// Time spent evaluating the stage
+    double busy_ms = 0;
+    /// Time spent waiting for the previous stage
+    double input_wait_ms = 0;
+    /// Time spent waiting for the next stage to take the results
+    double output_wait_ms = 0;
+    /// Time of the whole run
+    double total_ms = 0;
+
+    /// Fraction of the run spent evaluating the stage
+    double utilization() const;
+};
+
+/// Splits the main module into stages that are each compiled as their own program, with their
+/// own context, and runs micro batches through them so every stage works on a different batch
+/// at the same time. Each stage runs on its own thread with its own group of cores, and the
+/// stages are connected by bounded queues.
+struct pipeline
+{
+    pipeline(const program& p,
+             const target& t,
+             pipeline_options options = pipeline_options{},
+             compile_options compile  = compile_options{});
+    pipeline(const pipeline&) = delete;
+    pipeline& operator=(const pipeline&) = delete;
+    ~pipeline();
+
+    std::size_t stages() const;
+
+    /// Evaluate every batch, returning the outputs of the program for each batch in order
+    std::vector<std::vector<argument>> eval(const std::vector<parameter_map>& batches);
+
+    /// Utilization of each stage during the last eval
+    const std::vector<pipeline_stage_report>& get_report() const;
+    void print_report(std::ostream& os) const;
+
+    private:
+    std::unique_ptr<pipeline_impl> impl;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif // MIGRAPHX_GUARD_MIGRAPHX_PIPELINE_HPP
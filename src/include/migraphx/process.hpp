@@ -28,12 +28,16 @@
 #include <migraphx/filesystem.hpp>
 #include <string>
 #include <memory>
+#include <vector>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
 struct process_impl;
 
+/// Split a command line into arguments, honoring quotes and backslash escapes
+std::vector<std::string> split_command(const std::string& cmd);
+
 struct process
 {
     process(const std::string& cmd);
@@ -48,8 +52,12 @@ struct process
 
     process& cwd(const fs::path& p);
 
+    // Run the command, streaming its stdout and stderr a line at a time
     void exec();
 
+    // Run the command and return what it wrote to stdout
+    std::string read();
+
     private:
     std::unique_ptr<process_impl> impl;
 };
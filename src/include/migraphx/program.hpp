@@ -35,6 +35,7 @@
 #include <migraphx/compile_options.hpp>
 #include <migraphx/target_assignments.hpp>
 #include <migraphx/assignment_options.hpp>
+#include <migraphx/perf_options.hpp>
 #include <migraphx/env.hpp>
 #include <migraphx/config.hpp>
 #include <migraphx/execution_environment.hpp>
@@ -96,8 +97,11 @@ struct program
 
     void finalize();
 
-    void
-    perf_report(std::ostream& os, std::size_t n, parameter_map params, std::size_t batch = 1) const;
+    void perf_report(std::ostream& os,
+                     std::size_t n,
+                     parameter_map params,
+                     std::size_t batch           = 1,
+                     const perf_options& options = perf_options{}) const;
 
     void mark(const parameter_map& params, marker&& m);
 
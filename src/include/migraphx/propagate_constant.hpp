@@ -24,6 +24,7 @@
 #ifndef MIGRAPHX_GUARD_RTGLIB_PROPAGATE_CONSTANT_HPP
 #define MIGRAPHX_GUARD_RTGLIB_PROPAGATE_CONSTANT_HPP
 
+#include <cstddef>
 #include <string>
 #include <migraphx/config.hpp>
 
@@ -33,10 +34,15 @@ inline namespace MIGRAPHX_INLINE_NS {
 struct module;
 
 /**
- * Replace instructions which take all literals with a literal of the computation.
+ * Replace instructions which take all literals with a literal of the computation. Instructions
+ * that would expand broadcasted data into a larger literal are kept, and identical literals from
+ * folding are shared.
  */
 struct propagate_constant
 {
+    /// Maximum bytes of folded results that are computed at once. An instruction larger than the
+    /// budget is still folded by itself. There is no limit when it is 0.
+    std::size_t memory_budget = 1UL << 30U;
     std::string name() const { return "propagate_constant"; }
     void apply(module& m) const;
 };
@@ -40,11 +40,42 @@ struct program;
 
 void quantize_fp16(program& prog, const std::vector<std::string>& ins_names = {"all"});
 
+enum class int8_calibration
+{
+    /// Use the max absolute value of the tensors as the range
+    max_abs,
+    /// Use the range that covers a percentage of the absolute values of the tensors
+    percentile,
+    /// Use the range that minimizes the KL divergence between the float and int8 distributions
+    entropy
+};
+
+struct int8_quantization_options
+{
+    int8_calibration method = int8_calibration::max_abs;
+    /// Percentage of the values within the range for the percentile calibration
+    double percentile = 99.99;
+    /// Number of bins of the histograms for the percentile and entropy calibrations
+    std::size_t bins = 2048;
+    /// Number of calibration samples evaluated concurrently, each by its own compiled copy of the
+    /// program that uses an even share of the cores. With 0, up to 4 are used for targets that run
+    /// on the host and 1 for the other targets.
+    std::size_t num_threads = 0;
+    /// Quantize the constant weights of convolution and dot with one scale per output channel
+    bool per_channel = false;
+};
+
 void quantize_int8(program& prog,
                    const target& t,
                    const std::vector<parameter_map>& calibration,
                    const std::vector<std::string>& ins_names = {"dot", "convolution"});
 
+void quantize_int8(program& prog,
+                   const target& t,
+                   const std::vector<parameter_map>& calibration,
+                   const std::vector<std::string>& ins_names,
+                   const int8_quantization_options& options);
+
 } // namespace MIGRAPHX_INLINE_NS
 } // namespace migraphx
 
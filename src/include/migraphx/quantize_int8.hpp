@@ -55,6 +55,8 @@ struct quantize_int8_pass
 {
     std::vector<std::string> ins_names = {"dot", "convolution"};
     std::vector<std::pair<float, float>> quant_params;
+    /// Use one scale per output channel for the constant weights of convolution and dot
+    bool per_channel = false;
     std::string name() const { return "quantize_int8"; }
     void apply(module& m) const;
 };
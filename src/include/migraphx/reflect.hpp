@@ -125,6 +125,63 @@ void reflect_each(T& x, F f)
     });
 }
 
+template <class T>
+std::size_t reflect_hash(const T& x);
+
+namespace detail {
+
+inline void hash_combine(std::size_t& seed, std::size_t h)
+{
+    seed ^= h + 0x9e3779b9 + (seed << 6u) + (seed >> 2u);
+}
+
+template <class T>
+auto reflect_hash_impl(rank<4>, const T& x) -> decltype(std::hash<T>{}(x))
+{
+    return std::hash<T>{}(x);
+}
+
+template <class T>
+auto reflect_hash_impl(rank<3>, const T& x) -> decltype(std::size_t{x.hash()})
+{
+    return x.hash();
+}
+
+template <class T>
+auto reflect_hash_impl(rank<2>, const T& x) -> decltype(x.begin(), x.end(), std::size_t{})
+{
+    std::size_t result = 0;
+    for(auto&& y : x)
+        hash_combine(result, reflect_hash(y));
+    return result;
+}
+
+template <class T>
+auto reflect_hash_impl(rank<1>, const T& x)
+    -> decltype(T::reflect(x, reflect_placeholder{}), std::size_t{})
+{
+    std::size_t result = 0;
+    reflect_each(x, [&](auto&& y, auto&&...) { hash_combine(result, reflect_hash(y)); });
+    return result;
+}
+
+// A member that cannot be hashed does not contribute, so equal objects still hash equal
+template <class T>
+std::size_t reflect_hash_impl(rank<0>, const T&)
+{
+    return 0;
+}
+
+} // namespace detail
+
+/// Hash an object from its reflected members, recursing into ranges and reflectable members,
+/// without serializing it
+template <class T>
+std::size_t reflect_hash(const T& x)
+{
+    return detail::reflect_hash_impl(rank<4>{}, x);
+}
+
 template <class T>
 struct reflect_equality
 {
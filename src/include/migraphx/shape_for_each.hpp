@@ -26,7 +26,9 @@
 
 #include <migraphx/shape.hpp>
 #include <migraphx/config.hpp>
+#include <migraphx/reduce_dims.hpp>
 #include <algorithm>
+#include <array>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -35,20 +37,71 @@ template <class F>
 void shape_for_each(const migraphx::shape& s, F f)
 {
     // Ensure calls to f use const ref to vector
-    auto call = [&f](const std::vector<std::size_t>& i) { f(i); };
-    std::vector<std::size_t> indices(s.lens().size());
-    shape ss{s.type(), s.lens()};
-    for(std::size_t i = 0; i < ss.elements(); i++)
+    auto call        = [&f](const std::vector<std::size_t>& i) { f(i); };
+    const auto& lens = s.lens();
+    const auto n     = s.elements();
+    const auto ndim  = lens.size();
+    std::vector<std::size_t> indices(ndim, 0);
+    for(std::size_t i = 0; i < n; i++)
     {
-        std::transform(ss.strides().begin(),
-                       ss.strides().end(),
-                       ss.lens().begin(),
-                       indices.begin(),
-                       [&](std::size_t stride, std::size_t len) {
-                           assert(len > 0 and stride > 0);
-                           return (i / stride) % len;
-                       });
         call(indices);
+        // Advance the indices like an odometer instead of computing each one with a division
+        for(std::size_t d = ndim; d > 0; d--)
+        {
+            assert(lens[d - 1] > 0);
+            if(++indices[d - 1] < lens[d - 1])
+                break;
+            indices[d - 1] = 0;
+        }
+    }
+}
+
+/// Calls f with the offsets in each of the shapes of every element, in the order of a standard
+/// shape. All the shapes must have the same lens. The dimensions that are contiguous in all the
+/// shapes are merged, and the offsets are updated incrementally so there is no division or
+/// allocation per element.
+template <std::size_t N, class F>
+void shape_for_each_offset(const std::array<shape, N>& shapes, F f)
+{
+    static_assert(N > 0, "No shapes");
+    assert(std::all_of(shapes.begin(), shapes.end(), [&](const auto& s) {
+        return s.lens() == shapes.front().lens();
+    }));
+    auto call    = [&f](const std::array<std::size_t, N>& offsets) { f(offsets); };
+    const auto n = shapes.front().elements();
+    if(n == 0)
+        return;
+    auto rshapes     = reduce_dims(std::vector<shape>(shapes.begin(), shapes.end()));
+    const auto& lens = rshapes.front().lens();
+    const auto ndim  = lens.size();
+    std::array<std::size_t, N> inner_strides;
+    std::transform(rshapes.begin(), rshapes.end(), inner_strides.begin(), [](const auto& s) {
+        return s.strides().back();
+    });
+    const auto inner = lens.back();
+    std::vector<std::size_t> indices(ndim, 0);
+    std::array<std::size_t, N> start{};
+    for(std::size_t i = 0; i < n; i += inner)
+    {
+        auto offsets = start;
+        for(std::size_t j = 0; j < inner; j++)
+        {
+            call(offsets);
+            for(std::size_t k = 0; k < N; k++)
+                offsets[k] += inner_strides[k];
+        }
+        // Advance the outer dimensions like an odometer
+        for(std::size_t d = ndim - 1; d > 0; d--)
+        {
+            auto dim = d - 1;
+            for(std::size_t k = 0; k < N; k++)
+                start[k] += rshapes[k].strides()[dim];
+            if(++indices[dim] < lens[dim])
+                break;
+            for(std::size_t k = 0; k < N; k++)
+                start[k] -= rshapes[k].strides()[dim] * lens[dim];
+            indices[dim] = 0;
+        }
     }
 }
 
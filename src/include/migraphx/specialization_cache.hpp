@@ -0,0 +1,87 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_MIGRAPHLIB_SPECIALIZATION_CACHE_HPP
+#define MIGRAPHX_GUARD_MIGRAPHLIB_SPECIALIZATION_CACHE_HPP
+
+#include <migraphx/program.hpp>
+#include <migraphx/target.hpp>
+#include <migraphx/compile_options.hpp>
+#include <migraphx/config.hpp>
+#include <memory>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+/**
+ * Create a copy of the program where the dynamic parameters of the main module are replaced with
+ * the given static shapes. The shapes of all the instructions depending on the parameters are
+ * recomputed. Throws if a static shape is outside of the dynamic dimensions of its parameter.
+ */
+program specialize_program(const program& p,
+                           const std::unordered_map<std::string, shape>& param_shapes);
+
+struct specialization_cache_impl;
+
+/**
+ * Evaluates a program with dynamic parameters by compiling a static specialization of the program
+ * for each set of input shapes seen at eval. The compiled specializations are kept in a least
+ * recently used cache keyed by the lens of the dynamic parameters.
+ */
+struct specialization_cache
+{
+    specialization_cache(program p,
+                         target t,
+                         compile_options options = compile_options{},
+                         std::size_t capacity    = 8);
+
+    specialization_cache(specialization_cache&&) noexcept;
+    specialization_cache& operator=(specialization_cache&&) noexcept;
+
+    ~specialization_cache() noexcept;
+
+    /// Compile the specialization using the optimal lens of the dynamic parameters
+    void warmup();
+
+    /// Get the compiled specialization for the static input shapes. The program is not locked, so
+    /// it must not be evaluated concurrently with itself or with eval.
+    std::shared_ptr<program> get(const std::unordered_map<std::string, shape>& param_shapes);
+
+    /// Evaluate the specialization for the shapes of the parameters. This can be called from
+    /// several threads, but the evals of the same specialization run one at a time.
+    std::vector<argument> eval(parameter_map params);
+
+    std::size_t size() const;
+    std::size_t capacity() const;
+    std::size_t hits() const;
+    std::size_t misses() const;
+
+    private:
+    std::unique_ptr<specialization_cache_impl> impl;
+};
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
+
+#endif
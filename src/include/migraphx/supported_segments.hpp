@@ -34,6 +34,7 @@ inline namespace MIGRAPHX_INLINE_NS {
 struct supported_segment
 {
     std::unordered_set<instruction_ref> instructions;
+    // Relative cost of running each instruction of the segment on the target, lower is better
     float metric;
 };
 
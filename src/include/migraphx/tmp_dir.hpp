@@ -26,10 +26,13 @@
 
 #include <migraphx/config.hpp>
 #include <migraphx/filesystem.hpp>
+#include <string>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+std::string unique_string(const std::string& prefix);
+
 struct tmp_dir
 {
     fs::path path;
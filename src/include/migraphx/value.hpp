@@ -32,6 +32,7 @@
 #include <algorithm>
 #include <cassert>
 #include <memory>
+#include <new>
 #include <sstream>
 #include <type_traits>
 #include <tuple>
@@ -192,11 +193,34 @@ struct value
         }
     };
 
+    // Bytes owned by another object, which the value keeps alive through the owner. A value
+    // made from a view is a binary value. get_binary copies the bytes the first time it is
+    // called, while get_binary_view reads them in place.
+    struct binary_view
+    {
+        binary_view() {}
+        template <class T>
+        binary_view(const T* d, std::size_t s, std::shared_ptr<const void> o)
+            : data(reinterpret_cast<const std::uint8_t*>(d)), size(s), owner(std::move(o))
+        {
+        }
+
+        const std::uint8_t* data = nullptr;
+        std::size_t size         = 0;
+        std::shared_ptr<const void> owner;
+    };
+
     value() = default;
 
+    // Copies share the underlying array or object, which is only cloned when a copy is modified
     value(const value& rhs);
+    value(value&& rhs) noexcept;
     value& operator=(value rhs);
     value(const std::string& pkey, const value& rhs);
+    ~value();
+
+    value(binary_view v);
+    value(const std::string& pkey, binary_view v);
 
     value(const std::initializer_list<value>& i);
     value(const std::vector<value>& v, bool array_on_empty = true);
@@ -296,6 +320,8 @@ struct value
 
     bool is_null() const;
 
+    binary_view get_binary_view() const;
+
     const std::string& get_key() const;
     value* find(const std::string& pkey);
     const value* find(const std::string& pkey) const;
@@ -474,7 +500,22 @@ struct value
             r.begin(), r.end(), std::back_inserter(v), [&](auto&& e) { return value(e); });
         return v;
     }
+    // Numbers, booleans and strings that fit in the small string buffer are stored inline, so
+    // creating or copying them doesn't allocate. Everything else is held by x.
+    template <class T>
+    const T* inline_data() const
+    {
+        return std::launder(reinterpret_cast<const T*>(storage));
+    }
+    template <class Holder, class T>
+    void set_scalar(type_t t, T i);
+    void copy_inline(const value& rhs);
+    void move_inline(value& rhs) noexcept;
+    void destroy_inline() noexcept;
+
     std::shared_ptr<value_base_impl> x;
+    alignas(std::string) unsigned char storage[sizeof(std::string)] = {};
+    type_t inline_type = null_type;
     std::string key;
 };
 
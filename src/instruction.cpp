@@ -77,6 +77,7 @@ void instruction::replace(operation o)
 {
     normalized = false;
     op         = std::move(o);
+    op_hash    = 0;
     recompute_shape();
 }
 
@@ -153,6 +154,13 @@ const literal& instruction::get_literal() const
 
 const operation& instruction::get_operator() const { return op; }
 
+std::size_t instruction::get_operator_hash() const
+{
+    if(op_hash == 0)
+        op_hash = op.hash();
+    return op_hash;
+}
+
 std::string instruction::name() const { return op.name(); }
 
 const std::vector<instruction_ref>& instruction::inputs() const { return arguments; }
@@ -235,6 +243,7 @@ void instruction::replace(operation o, const shape& r, std::vector<instruction_r
 {
     normalized = false;
     op         = std::move(o);
+    op_hash    = 0;
     replace(r);
     replace(std::move(args));
 }
@@ -244,7 +253,8 @@ void instruction::replace(operation o,
                           std::vector<instruction_ref> args,
                           std::vector<module_ref> mdl_args)
 {
-    op = std::move(o);
+    op      = std::move(o);
+    op_hash = 0;
     replace(r);
     replace(std::move(args), std::move(mdl_args));
 }
@@ -342,7 +352,10 @@ argument instruction::eval(bool check_eval) const
 void instruction::finalize(context& ctx)
 {
     if(has_finalize(this->op))
+    {
         this->op.finalize(ctx, this->get_shape(), to_shapes(this->inputs()));
+        op_hash = 0;
+    }
 }
 
 void instruction::print(std::ostream& os,
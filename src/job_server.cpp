@@ -0,0 +1,95 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/job_server.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/env.hpp>
+#include <atomic>
+#include <exception>
+#include <iostream>
+#include <mutex>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_COMPILE_JOBS)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_COMPILE_JOBS)
+
+job_server::job_server(std::size_t n)
+{
+    if(n == 0)
+        n = value_of(MIGRAPHX_COMPILE_JOBS{}, std::thread::hardware_concurrency());
+    workers = std::max<std::size_t>(1, n);
+}
+
+void job_server::run(std::size_t n, const std::function<void(std::size_t)>& f) const
+{
+    if(n == 0)
+        return;
+    std::atomic<std::size_t> next{0};
+    std::size_t finished = 0;
+    std::exception_ptr error;
+    std::mutex m;
+    // Each worker pulls the next job, so a slow job doesn't hold up a fixed
+    // chunk of the others behind it
+    auto worker = [&] {
+        for(auto i = next++; i < n; i = next++)
+        {
+            try
+            {
+                f(i);
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(m);
+                if(not error)
+                    error = std::current_exception();
+                next = n;
+                return;
+            }
+            std::lock_guard<std::mutex> lock(m);
+            finished++;
+            if(progress)
+                progress(finished, n);
+            if(enabled(MIGRAPHX_TRACE_COMPILE_JOBS{}))
+                std::cout << "Finished job " << finished << "/" << n << std::endl;
+        }
+    };
+    auto nworkers = std::min(workers, n);
+    if(nworkers == 1)
+    {
+        worker();
+    }
+    else
+    {
+        std::vector<joinable_thread> threads;
+        threads.reserve(nworkers);
+        for(std::size_t t = 0; t < nworkers; t++)
+            threads.emplace_back(worker);
+    }
+    if(error)
+        std::rethrow_exception(error);
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -25,6 +25,7 @@
 #include <migraphx/module.hpp>
 #include <migraphx/stringutils.hpp>
 #include <migraphx/instruction.hpp>
+#include <migraphx/eval_plan.hpp>
 #include <migraphx/target.hpp>
 #include <migraphx/env.hpp>
 #include <migraphx/ranges.hpp>
@@ -36,10 +37,12 @@
 #include <migraphx/register_target.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/json.hpp>
+#include <migraphx/job_server.hpp>
 #include <iostream>
 #include <sstream>
 #include <algorithm>
 #include <set>
+#include <thread>
 #include <utility>
 #include <unordered_set>
 
@@ -47,6 +50,7 @@ namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_FINALIZE)
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_FINALIZE_JOBS)
 
 struct module_impl
 {
@@ -56,6 +60,8 @@ struct module_impl
     std::string name;
     uint32_t nparams = 0;
     bool bypass      = false;
+    // Built by finalize, and dropped whenever the instructions change
+    std::shared_ptr<const eval_plan> plan = nullptr;
 
     bool contains(instruction_ref ins) const
     {
@@ -70,6 +76,7 @@ struct module_impl
         // cppcheck-suppress redundantInitialization
         auto r = instructions.emplace(pos, std::forward<Ts>(xs)...);
         instruction_set.insert(std::addressof(*r));
+        plan = nullptr;
         return r;
     }
     instruction_ref insert(instruction_ref pos, const instruction& ins)
@@ -82,6 +89,7 @@ struct module_impl
         instructions.clear();
         instruction_set.clear();
         nparams = 0;
+        plan    = nullptr;
     }
 
     void push_front(const instruction& ins) { insert(instructions.begin(), ins); }
@@ -103,12 +111,14 @@ struct module_impl
     instruction_ref erase(instruction_ref pos)
     {
         instruction_set.erase(std::addressof(*pos));
+        plan = nullptr;
         return instructions.erase(pos);
     }
 
     instruction_ref erase(instruction_ref start, instruction_ref last)
     {
         std::for_each(start, last, [&](auto& ins) { instruction_set.erase(std::addressof(ins)); });
+        plan = nullptr;
         return instructions.erase(start, last);
     }
 };
@@ -143,7 +153,8 @@ void module::assign(const module& m)
     // copy the impl
     if(not impl)
         impl = std::make_unique<module_impl>();
-    *impl = *m.impl;
+    *impl      = *m.impl;
+    impl->plan = nullptr;
 
     // clear instructions
     if(not impl->instructions.empty())
@@ -301,6 +312,7 @@ instruction_ref module::replace_instruction(instruction_ref ins,
 
     shape r = compute_shape(op, args);
     instruction::replace(ins, op, r, std::move(args));
+    impl->plan = nullptr;
     assert(ins->valid(begin()));
     return ins;
 }
@@ -314,6 +326,7 @@ instruction_ref module::replace_instruction(instruction_ref ins,
     assert(not starts_with(op.name(), "@"));
     auto out_shape = compute_shape(op, args, module_args);
     instruction::replace(ins, op, out_shape, std::move(args), std::move(module_args));
+    impl->plan = nullptr;
     assert(ins->valid(begin()));
     return ins;
 }
@@ -334,6 +347,7 @@ instruction_ref module::replace_instruction(instruction_ref ins, instruction_ref
     {
         return rep;
     }
+    impl->plan = nullptr;
     // Make a copy of outputs which can be changed when calling replace_argument
     auto outputs = ins->outputs();
     for(auto out : outputs)
@@ -380,6 +394,7 @@ instruction_ref module::move_instruction(instruction_ref src, instruction_ref ds
     assert(has_instruction(src));
     assert(has_instruction(dst) or is_end(dst, this->end()));
     impl->instructions.splice(dst, impl->instructions, src);
+    impl->plan = nullptr;
     return src;
 }
 
@@ -489,6 +504,7 @@ instruction_ref module::replace_return(std::vector<instruction_ref> args)
 
     shape r = compute_shape(last->get_operator(), args);
     instruction::replace(last, last->get_operator(), r, std::move(args));
+    impl->plan = nullptr;
     assert(last->valid(begin()));
 
     return last;
@@ -595,6 +611,8 @@ std::vector<shape> module::get_output_shapes() const
     }
 }
 
+const eval_plan* module::get_eval_plan() const { return impl->plan.get(); }
+
 instruction_ref module::validate() const
 {
     return std::find_if(
@@ -645,6 +663,10 @@ instruction_ref module::find_dangling_reference() const
 void module::finalize(context& ctx)
 {
     const bool trace = enabled(MIGRAPHX_TRACE_FINALIZE{});
+    // Operators that declare a thread-safe finalize only touch their own
+    // state, so they are finalized together after the others, which still
+    // run in order. The result doesn't depend on how the jobs are scheduled.
+    std::vector<instruction_ref> threadsafe;
     for(auto ins : iterator_for(*this))
     {
         if(trace)
@@ -652,12 +674,19 @@ void module::finalize(context& ctx)
             std::cout << "Finalize: ";
             this->debug_print(ins);
         }
-        ins->finalize(ctx);
+        const auto& op = ins->get_operator();
+        if(has_finalize(op) and op.attributes().get("threadsafe_finalize", false))
+            threadsafe.push_back(ins);
+        else
+            ins->finalize(ctx);
         for(const auto& smod : ins->module_inputs())
         {
             smod->finalize(ctx);
         }
     }
+    job_server js{value_of(MIGRAPHX_FINALIZE_JOBS{}, std::thread::hardware_concurrency())};
+    js.run(threadsafe.size(), [&](std::size_t i) { threadsafe[i]->finalize(ctx); });
+    impl->plan = std::make_shared<eval_plan>(make_eval_plan(*this));
 
     // Warn when an instruction is not normalized
     auto ins = std::find_if(begin(), end(), [](auto& i) { return i.need_normalization(); });
@@ -114,8 +114,14 @@ struct onnx_parser
     void parse_from(std::istream& is, std::string name = "");
     void parse_from(const void* data, std::size_t size);
     void parse_graph(module* mod, const onnx::GraphProto& graph);
+    // Moves the initializers out of the graph and releases their protobuf data once converted
+    void parse_graph(module* mod, onnx::GraphProto&& graph);
+    void parse_graph_nodes(module* mod,
+                           const onnx::GraphProto& graph,
+                           std::unordered_map<std::string, instruction_ref> mod_insts);
     literal parse_value(const onnx::AttributeProto& attr) const;
     literal parse_tensor(const onnx::TensorProto& t) const;
+    literal take_tensor(onnx::TensorProto& t) const;
     shape parse_type(const onnx::TypeProto& t, const std::vector<std::size_t>& input_dims) const;
 };
 
@@ -33,8 +33,10 @@
 #include <migraphx/float_equal.hpp>
 #include <migraphx/file_buffer.hpp>
 #include <migraphx/filesystem.hpp>
+#include <migraphx/par_for.hpp>
 #include <migraphx/op/unknown.hpp>
 #include <migraphx/env.hpp>
+#include <exception>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -68,6 +70,29 @@ create_literal(shape::type_t shape_type, const std::vector<size_t>& dims, const
     return literal{{shape_type, dims}, data};
 }
 
+// Creates a literal that keeps the buffer alive instead of copying the data out of it
+template <class Buffer>
+static literal create_owned_literal(shape::type_t shape_type,
+                                    const std::vector<size_t>& dims,
+                                    std::shared_ptr<Buffer> buffer)
+{
+    // empty input
+    auto elem_num =
+        std::accumulate(dims.begin(), dims.end(), std::size_t(1), std::multiplies<std::size_t>());
+    if(elem_num == 0)
+    {
+        return literal{shape_type};
+    }
+
+    shape s     = dims.empty() ? shape{shape_type} : shape{shape_type, dims};
+    auto nbytes = buffer->size() * sizeof(typename Buffer::value_type);
+    if(nbytes < s.bytes())
+        MIGRAPHX_THROW("Tensor data has " + std::to_string(nbytes) + " bytes but " +
+                       std::to_string(s.bytes()) + " bytes are needed");
+    auto* data = reinterpret_cast<char*>(buffer->data());
+    return literal{argument{s, std::shared_ptr<char>(std::move(buffer), data)}};
+}
+
 template <class T, MIGRAPHX_REQUIRES(not std::is_pointer<T>{})>
 static literal create_literal(shape::type_t shape_type, const std::vector<size_t>& dims, T data)
 {
@@ -85,6 +110,31 @@ static literal create_literal(shape::type_t shape_type, const std::vector<size_t
     return literal{{shape_type, dims}, data.begin(), data.end()};
 }
 
+// Converts the tensors on multiple threads. Exceptions are rethrown in order on the calling thread
+// so errors are reported the same as when parsing serially.
+template <class F>
+static std::vector<literal> parse_tensors(std::size_t n, F f)
+{
+    std::vector<literal> literals(n);
+    std::vector<std::exception_ptr> errors(n);
+    par_for(n, 1, [&](auto i) {
+        try
+        {
+            literals[i] = f(i);
+        }
+        catch(...)
+        {
+            errors[i] = std::current_exception();
+        }
+    });
+    for(const auto& e : errors)
+    {
+        if(e)
+            std::rethrow_exception(e);
+    }
+    return literals;
+}
+
 template <class T>
 static literal from_repeated(shape::type_t t, const T& r)
 {
@@ -210,7 +260,7 @@ void onnx_parser::parse_from(std::istream& is, std::string name)
 
         if(model.has_graph())
         {
-            this->parse_graph(mm, model.graph());
+            this->parse_graph(mm, std::move(*model.mutable_graph()));
         }
     }
     else
@@ -230,7 +280,7 @@ void onnx_parser::parse_from(const void* data, std::size_t size)
 
         if(model.has_graph())
         {
-            this->parse_graph(mm, model.graph());
+            this->parse_graph(mm, std::move(*model.mutable_graph()));
         }
     }
     else
@@ -256,13 +306,39 @@ int64_t onnx_parser::get_opset_version(const onnx::ModelProto& model)
 
 void onnx_parser::parse_graph(module* mod, const onnx::GraphProto& graph)
 {
+    const auto& initializers = graph.initializer();
+    auto literals            = parse_tensors(
+        initializers.size(), [&](auto i) { return this->parse_tensor(initializers.Get(i)); });
     std::unordered_map<std::string, instruction_ref> mod_insts;
-    for(auto&& f : graph.initializer())
+    for(int i = 0; i < initializers.size(); i++)
     {
         // backup instructions in parent mod
-        mod_insts[f.name()] = mod->add_literal(parse_tensor(f));
+        mod_insts[initializers.Get(i).name()] = mod->add_literal(std::move(literals[i]));
     }
+    this->parse_graph_nodes(mod, graph, std::move(mod_insts));
+}
+
+void onnx_parser::parse_graph(module* mod, onnx::GraphProto&& graph)
+{
+    auto& initializers = *graph.mutable_initializer();
+    std::vector<std::string> names;
+    names.reserve(initializers.size());
+    for(const auto& f : initializers)
+        names.push_back(f.name());
+    auto literals = parse_tensors(initializers.size(), [&](auto i) {
+        return this->take_tensor(*initializers.Mutable(i));
+    });
+    graph.clear_initializer();
+    std::unordered_map<std::string, instruction_ref> mod_insts;
+    for(std::size_t i = 0; i < literals.size(); i++)
+        mod_insts[names[i]] = mod->add_literal(std::move(literals[i]));
+    this->parse_graph_nodes(mod, graph, std::move(mod_insts));
+}
 
+void onnx_parser::parse_graph_nodes(module* mod,
+                                    const onnx::GraphProto& graph,
+                                    std::unordered_map<std::string, instruction_ref> mod_insts)
+{
     for(auto&& input : graph.input())
     {
         const std::string& name = input.name();
@@ -395,11 +471,23 @@ literal onnx_parser::parse_tensor(const onnx::TensorProto& t) const
     std::vector<std::size_t> dims(t.dims().begin(), t.dims().end());
     if(not t.external_data().empty())
     {
-        const std::string& data_file = t.external_data().at(0).value();
-        auto raw_buffer              = read_buffer(path + "/" + data_file);
-        std::string s(raw_buffer.begin(), raw_buffer.end());
+        std::string data_file = t.external_data().at(0).value();
+        std::size_t offset    = 0;
+        std::size_t length    = 0;
+        for(auto&& entry : t.external_data())
+        {
+            if(entry.key() == "location")
+                data_file = entry.value();
+            else if(entry.key() == "offset")
+                offset = std::stoull(entry.value());
+            else if(entry.key() == "length")
+                length = std::stoull(entry.value());
+        }
+        // Only read this tensor's bytes and use the buffer for the literal directly
+        auto raw_buffer = std::make_shared<std::vector<char>>(
+            read_buffer(path + "/" + data_file, offset, length));
         auto type = get_type(t.data_type());
-        return create_literal(type, dims, s.data());
+        return create_owned_literal(type, dims, std::move(raw_buffer));
     }
     if(t.has_raw_data())
     {
@@ -422,13 +510,10 @@ literal onnx_parser::parse_tensor(const onnx::TensorProto& t) const
     case onnx::TensorProto::UINT64:
         return create_literal(shape::uint64_type, dims, t.uint64_data());
     case onnx::TensorProto::FLOAT16: {
-        std::vector<uint16_t> data_uint16(t.int32_data().begin(), t.int32_data().end());
-        std::vector<half> data_half;
-        std::transform(data_uint16.begin(),
-                       data_uint16.end(),
-                       std::back_inserter(data_half),
-                       [](uint16_t raw_val) { return *reinterpret_cast<half*>(&raw_val); });
-        return create_literal(shape::half_type, dims, data_half);
+        // The bits of each half are stored in an int32, so narrow them into the literal's buffer
+        auto data_uint16 =
+            std::make_shared<std::vector<uint16_t>>(t.int32_data().begin(), t.int32_data().end());
+        return create_owned_literal(shape::half_type, dims, std::move(data_uint16));
     }
     case onnx::TensorProto::DOUBLE:
         return create_literal(shape::double_type, dims, t.double_data());
@@ -440,6 +525,26 @@ literal onnx_parser::parse_tensor(const onnx::TensorProto& t) const
     }
     MIGRAPHX_THROW("PARSE_TENSOR: Invalid tensor type");
 }
+literal onnx_parser::take_tensor(onnx::TensorProto& t) const
+{
+    literal result;
+    if(t.external_data().empty() and t.has_raw_data())
+    {
+        // Take over the raw data string from the protobuf rather than copying it
+        std::vector<std::size_t> dims(t.dims().begin(), t.dims().end());
+        auto raw_data = std::make_shared<std::string>();
+        raw_data->swap(*t.mutable_raw_data());
+        result = create_owned_literal(get_type(t.data_type()), dims, std::move(raw_data));
+    }
+    else
+    {
+        result = parse_tensor(t);
+    }
+    // Release what is left of the tensor now that the literal owns its data
+    onnx::TensorProto{}.Swap(&t);
+    return result;
+}
+
 shape onnx_parser::parse_type(const onnx::TypeProto& t,
                               const std::vector<std::size_t>& input_dims) const
 {
@@ -0,0 +1,286 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/partition.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/builtin.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/pass.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/reflect.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/register_target.hpp>
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+// Evaluate a partition compiled for another target. The inputs are copied to the target and the
+// outputs are copied back, so data only moves between targets at the partition boundaries.
+struct run_on_target
+{
+    std::string target_name;
+    std::shared_ptr<const program> prog;
+    target t;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.target_name, "target"));
+    }
+
+    std::string name() const { return "run_on_target"; }
+
+    // Partitions for the same target only compare equal when they run the same program, so
+    // eliminate_common_subexpression never merges different partitions
+    friend bool operator==(const run_on_target& x, const operation& y)
+    {
+        if(x.name() != y.name())
+            return false;
+        const auto& yy = any_cast<run_on_target>(y);
+        return x.target_name == yy.target_name and x.prog == yy.prog;
+    }
+
+    std::size_t hash() const
+    {
+        std::size_t result = std::hash<std::string>{}(name());
+        detail::hash_combine(result, std::hash<std::string>{}(target_name));
+        detail::hash_combine(result, std::hash<const program*>{}(prog.get()));
+        return result;
+    }
+
+    value to_value() const
+    {
+        return {{"target", target_name}, {"program", prog ? prog->to_value() : value{}}};
+    }
+
+    void from_value(const value& v)
+    {
+        target_name = v.at("target").to<std::string>();
+        if(target_name.empty())
+            return;
+        t = make_target(target_name);
+        if(v.at("program").is_null())
+            return;
+        auto p = std::make_shared<program>();
+        p->from_value(v.at("program"));
+        prog = p;
+    }
+
+    shape compute_shape(const std::vector<shape>&) const
+    {
+        auto shapes = prog->get_output_shapes();
+        if(shapes.size() == 1)
+            return shapes.front();
+        return shape{shapes};
+    }
+
+    argument compute(const shape&, const std::vector<argument>& args) const
+    {
+        parameter_map params;
+        for(std::size_t i = 0; i < args.size(); i++)
+            params[std::to_string(i)] = t.copy_to(args[i]);
+        // Parameters added by the passes of the target are allocated on the target
+        for(auto&& ps : prog->get_parameter_shapes())
+        {
+            if(not contains(params, ps.first))
+                params[ps.first] = t.allocate(ps.second);
+        }
+        auto results = prog->eval(params);
+        std::transform(results.begin(), results.end(), results.begin(), [&](const auto& r) {
+            return t.copy_from(r);
+        });
+        if(results.size() == 1)
+            return results.front();
+        return argument{results};
+    }
+};
+MIGRAPHX_REGISTER_OP(run_on_target)
+
+// The program that runs the partitions only passes arguments between them on the host
+struct partition_context
+{
+    void finish() const {}
+};
+
+struct partition_target
+{
+    std::string name() const { return "partition"; }
+    std::vector<pass> get_passes(context&, const compile_options&) const { return {}; }
+    context get_context() const { return partition_context{}; }
+};
+MIGRAPHX_REGISTER_TARGET(partition_target);
+
+struct partition
+{
+    std::size_t target_index = 0;
+    std::vector<instruction_ref> instructions;
+};
+
+static std::vector<partition> find_partitions(const module& m,
+                                              const std::vector<target>& targets,
+                                              const target_assignments& assignments)
+{
+    std::vector<partition> partitions;
+    for(auto ins : iterator_for(m))
+    {
+        if(starts_with(ins->name(), "@"))
+            continue;
+        if(not ins->module_inputs().empty())
+            MIGRAPHX_THROW("COMPILE_PARTITIONS: Submodules are not supported: " + ins->name());
+        auto it = assignments.find(ins);
+        if(it == assignments.end())
+            MIGRAPHX_THROW("COMPILE_PARTITIONS: No target supports " + ins->name());
+        auto t = std::find_if(targets.begin(), targets.end(), [&](const auto& x) {
+            return x.name() == it->second;
+        });
+        std::size_t index = std::distance(targets.begin(), t);
+        if(partitions.empty() or partitions.back().target_index != index)
+            partitions.push_back({index, {}});
+        partitions.back().instructions.push_back(ins);
+    }
+    return partitions;
+}
+
+module_partition make_partition(const module& m, const std::vector<instruction_ref>& instructions)
+{
+    std::unordered_set<instruction_ref> in_partition(instructions.begin(), instructions.end());
+    auto last = std::prev(m.end());
+
+    module_partition result;
+    auto* pm = result.prog.get_main_module();
+    std::unordered_map<instruction_ref, instruction_ref> map;
+    for(auto ins : instructions)
+    {
+        std::vector<instruction_ref> inputs;
+        for(auto input : ins->inputs())
+        {
+            if(not contains(map, input))
+            {
+                if(input->name() == "@literal")
+                {
+                    map[input] = pm->add_literal(input->get_literal());
+                }
+                else
+                {
+                    map[input] = pm->add_parameter(std::to_string(result.inputs.size()),
+                                                   input->get_shape());
+                    result.inputs.push_back(input);
+                }
+            }
+            inputs.push_back(map.at(input));
+        }
+        map[ins] = pm->add_instruction(ins->get_operator(), inputs);
+        bool used_after =
+            std::any_of(ins->outputs().begin(), ins->outputs().end(), [&](auto output) {
+                return not contains(in_partition, output);
+            });
+        if(ins == last or used_after)
+            result.outputs.push_back(ins);
+    }
+    std::vector<instruction_ref> returns;
+    std::transform(result.outputs.begin(),
+                   result.outputs.end(),
+                   std::back_inserter(returns),
+                   [&](auto ins) { return map.at(ins); });
+    pm->add_return(returns);
+    return result;
+}
+
+void compile_partitions(program& p,
+                        const std::vector<target>& targets,
+                        compile_options options,
+                        assignment_options assignment)
+{
+    const auto* mm  = p.get_main_module();
+    auto partitions = find_partitions(*mm, targets, p.get_target_assignments(targets, assignment));
+
+    auto last = std::prev(mm->end());
+
+    program result;
+    auto* rm = result.get_main_module();
+    std::unordered_map<instruction_ref, instruction_ref> host_map;
+    auto get_host = [&](instruction_ref ins) {
+        if(not contains(host_map, ins) and ins->name() == "@literal")
+            host_map[ins] = rm->add_literal(ins->get_literal());
+        return host_map.at(ins);
+    };
+    for(auto ins : iterator_for(*mm))
+    {
+        if(ins->name() == "@param")
+        {
+            auto name     = any_cast<builtin::param>(ins->get_operator()).parameter;
+            host_map[ins] = rm->add_parameter(name, ins->get_shape());
+        }
+    }
+
+    for(std::size_t i = 0; i < partitions.size(); i++)
+    {
+        const auto& t = targets[partitions[i].target_index];
+        auto pp       = make_partition(*mm, partitions[i].instructions);
+        pp.prog.compile(t, options);
+        std::vector<instruction_ref> host_inputs;
+        std::transform(
+            pp.inputs.begin(), pp.inputs.end(), std::back_inserter(host_inputs), get_host);
+        const auto& outputs = pp.outputs;
+
+        auto r = rm->add_instruction(
+            run_on_target{t.name(), std::make_shared<program>(std::move(pp.prog)), t}, host_inputs);
+        if(outputs.size() == 1)
+        {
+            host_map[outputs.front()] = r;
+            continue;
+        }
+        for(std::size_t j = 0; j < outputs.size(); j++)
+        {
+            host_map[outputs[j]] =
+                rm->add_instruction(make_op("get_tuple_elem", {{"index", j}}), r);
+        }
+    }
+
+    std::vector<instruction_ref> returns;
+    if(last->name() == "@return")
+    {
+        std::transform(last->inputs().begin(),
+                       last->inputs().end(),
+                       std::back_inserter(returns),
+                       get_host);
+    }
+    else
+    {
+        returns.push_back(get_host(last));
+    }
+    rm->add_return(returns);
+    result.compile(partition_target{}, options);
+    p = std::move(result);
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,250 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/perf_counters.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/filesystem.hpp>
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+const std::size_t cache_line_size = 64;
+
+perf_counter_values& perf_counter_values::operator+=(const perf_counter_values& x)
+{
+    cycles += x.cycles;
+    instructions += x.instructions;
+    cache_misses += x.cache_misses;
+    return *this;
+}
+
+double perf_counter_values::ipc() const
+{
+    if(cycles == 0)
+        return 0;
+    return double(instructions) / cycles;
+}
+
+double perf_counter_values::memory_bytes() const { return double(cache_misses) * cache_line_size; }
+
+#ifdef __linux__
+const std::array<std::uint64_t, 3> counter_configs = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES};
+
+static int open_counter(std::uint64_t config, int tid)
+{
+    perf_event_attr attr{};
+    attr.size           = sizeof(attr);
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.config         = config;
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    // Also count the threads the thread creates while the counter is open
+    attr.inherit = 1;
+    return syscall(__NR_perf_event_open, &attr, tid, -1, -1, 0); // NOLINT
+}
+
+// The calling thread comes first, followed by the other threads of the process
+static std::vector<int> process_threads()
+{
+    std::vector<int> result = {0};
+    std::error_code ec;
+    for(const auto& entry : fs::directory_iterator("/proc/self/task", ec))
+    {
+        auto tid = std::stoi(entry.path().filename().string());
+        if(tid != syscall(SYS_gettid)) // NOLINT
+            result.push_back(tid);
+    }
+    return result;
+}
+
+perf_counters::perf_counters()
+{
+    for(auto tid : process_threads())
+    {
+        std::vector<int> thread_fds;
+        for(auto config : counter_configs)
+        {
+            int fd = open_counter(config, tid);
+            if(fd < 0)
+                break;
+            thread_fds.push_back(fd);
+        }
+        if(thread_fds.size() == counter_configs.size())
+        {
+            fds.insert(fds.end(), thread_fds.begin(), thread_fds.end());
+            continue;
+        }
+        for(auto x : thread_fds)
+            close(x);
+        // Without the counters of the calling thread nothing is measured. Another thread may
+        // have exited since the threads were listed.
+        if(tid == 0)
+            return;
+    }
+}
+
+perf_counters::~perf_counters()
+{
+    for(auto fd : fds)
+        close(fd);
+}
+
+void perf_counters::start()
+{
+    for(auto fd : fds)
+    {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0); // NOLINT
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0); // NOLINT
+    }
+}
+
+perf_counter_values perf_counters::stop()
+{
+    std::array<std::uint64_t, counter_configs.size()> totals{};
+    for(std::size_t i = 0; i < fds.size(); i++)
+    {
+        ioctl(fds[i], PERF_EVENT_IOC_DISABLE, 0); // NOLINT
+        std::uint64_t value = 0;
+        if(read(fds[i], &value, sizeof(value)) == sizeof(value))
+            totals[i % totals.size()] += value;
+    }
+    perf_counter_values result;
+    result.cycles       = totals[0];
+    result.instructions = totals[1];
+    result.cache_misses = totals[2];
+    return result;
+}
+#else
+perf_counters::perf_counters() {}
+perf_counters::~perf_counters() {}
+void perf_counters::start() {}
+perf_counter_values perf_counters::stop() { return {}; }
+#endif
+
+bool perf_counters::available() const { return not fds.empty(); }
+
+std::size_t perf_counters::threads() const
+{
+#ifdef __linux__
+    return fds.size() / counter_configs.size();
+#else
+    return 0;
+#endif
+}
+
+// Lowered operators are named after the target, such as ref::dot or dnnl::convolution
+static std::string base_name(const std::string& name)
+{
+    auto pos = name.rfind("::");
+    if(pos == std::string::npos)
+        return name;
+    return name.substr(pos + 2);
+}
+
+static bool is_data_movement(const std::string& name)
+{
+    static const std::vector<std::string> names = {"allocate",
+                                                   "broadcast",
+                                                   "concat",
+                                                   "contiguous",
+                                                   "copy",
+                                                   "gather",
+                                                   "get_tuple_elem",
+                                                   "identity",
+                                                   "load",
+                                                   "multibroadcast",
+                                                   "pad",
+                                                   "preallocate",
+                                                   "reorder",
+                                                   "reshape",
+                                                   "slice",
+                                                   "squeeze",
+                                                   "transpose",
+                                                   "unsqueeze"};
+    return starts_with(name, "@") or contains(names, name);
+}
+
+double estimate_flops(instruction_ref ins)
+{
+    auto name = base_name(ins->name());
+    if(is_data_movement(name) or ins->get_shape().type() == shape::tuple_type)
+        return 0;
+    const auto& inputs = ins->inputs();
+    double elements    = ins->get_shape().elements();
+    if(contains({"dot", "quant_dot"}, name))
+        return 2 * elements * inputs.front()->get_shape().lens().back();
+    if(contains({"convolution", "quant_convolution"}, name))
+    {
+        const auto& w = inputs.at(1)->get_shape();
+        return 2 * elements * (w.elements() / w.lens().front());
+    }
+    if(name == "deconvolution")
+    {
+        const auto& w = inputs.at(1)->get_shape();
+        return 2.0 * inputs.front()->get_shape().elements() * (w.elements() / w.lens().front());
+    }
+    // Every input element is combined once for reductions and pooling
+    if(starts_with(name, "reduce") or contains({"reduction", "pooling"}, name))
+        return inputs.front()->get_shape().elements();
+    return elements;
+}
+
+double estimate_bytes(instruction_ref ins)
+{
+    if(starts_with(ins->name(), "@"))
+        return 0;
+    auto inputs = to_shapes(ins->inputs());
+    auto alias  = ins->get_operator().output_alias(inputs);
+    // Views don't move any data
+    if(alias >= 0 and estimate_flops(ins) == 0 and
+       not contains({"concat", "contiguous", "copy", "gather", "pad", "reorder"},
+                    base_name(ins->name())))
+        return 0;
+    double result = ins->get_shape().bytes();
+    for(std::size_t i = 0; i < inputs.size(); i++)
+    {
+        // The output buffer passed as an input is already counted
+        if(alias >= 0 and i == static_cast<std::size_t>(alias))
+            continue;
+        result += inputs[i].bytes();
+    }
+    return result;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,471 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/pipeline.hpp>
+#include <migraphx/partition.hpp>
+#include <migraphx/perf_counters.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/builtin.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/errors.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+double pipeline_stage_report::utilization() const
+{
+    if(total_ms <= 0)
+        return 0;
+    return busy_ms / total_ms;
+}
+
+// A micro batch holds the values passed between the stages, indexed by value id
+struct micro_batch
+{
+    std::size_t index = 0;
+    std::vector<argument> values;
+};
+
+// Connects two stages. Pushing blocks while the queue is full, and closing the queue wakes up every
+// thread waiting on it. Items already queued can still be popped after it is closed.
+struct micro_batch_queue
+{
+    explicit micro_batch_queue(std::size_t n) : capacity(std::max<std::size_t>(n, 1)) {}
+
+    bool push(micro_batch b)
+    {
+        std::unique_lock<std::mutex> lock(m);
+        not_full.wait(lock, [&] { return closed or items.size() < capacity; });
+        if(closed)
+            return false;
+        items.push_back(std::move(b));
+        not_empty.notify_one();
+        return true;
+    }
+
+    bool pop(micro_batch& b)
+    {
+        std::unique_lock<std::mutex> lock(m);
+        not_empty.wait(lock, [&] { return closed or not items.empty(); });
+        if(items.empty())
+            return false;
+        b = std::move(items.front());
+        items.pop_front();
+        not_full.notify_one();
+        return true;
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(m);
+        closed = true;
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+
+    private:
+    std::size_t capacity;
+    std::deque<micro_batch> items;
+    bool closed = false;
+    std::mutex m;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;
+};
+
+struct pipeline_stage
+{
+    program prog;
+    std::vector<std::size_t> inputs;
+    std::vector<std::size_t> outputs;
+    std::vector<std::size_t> cores;
+    std::size_t instructions = 0;
+    // Parameters added by the passes of the target, allocated once since only the stage's thread
+    // uses them
+    parameter_map scratch;
+};
+
+struct pipeline_result
+{
+    std::size_t id = 0;
+    argument constant;
+    bool is_constant = false;
+};
+
+struct pipeline_impl
+{
+    target t;
+    pipeline_options options;
+    std::size_t nvalues = 0;
+    std::vector<std::pair<std::string, std::size_t>> parameters;
+    std::vector<pipeline_stage> stages;
+    std::vector<pipeline_result> results;
+    std::vector<pipeline_stage_report> report;
+};
+
+static std::vector<std::size_t> available_cores()
+{
+    std::vector<std::size_t> result;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if(sched_getaffinity(0, sizeof(set), &set) == 0)
+    {
+        for(std::size_t i = 0; i < CPU_SETSIZE; i++)
+        {
+            if(CPU_ISSET(i, &set))
+                result.push_back(i);
+        }
+    }
+#endif
+    if(result.empty())
+    {
+        result.resize(std::max<std::size_t>(1, std::thread::hardware_concurrency()));
+        std::iota(result.begin(), result.end(), 0);
+    }
+    return result;
+}
+
+// Threads created afterwards by the calling thread inherit the affinity, so the thread pool of the
+// stage stays on its cores
+static void pin_thread(const std::vector<std::size_t>& cores)
+{
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(auto core : cores)
+        CPU_SET(core, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+#else
+    (void)cores;
+#endif
+}
+
+// Cut the instructions so each stage has about the same estimated work
+static std::vector<std::vector<instruction_ref>>
+balance_stages(const std::vector<instruction_ref>& instructions, std::size_t n)
+{
+    std::vector<double> costs;
+    std::transform(instructions.begin(),
+                   instructions.end(),
+                   std::back_inserter(costs),
+                   [](auto ins) { return estimate_flops(ins) + estimate_bytes(ins); });
+    double total = std::accumulate(costs.begin(), costs.end(), 0.0);
+    if(total <= 0)
+    {
+        std::fill(costs.begin(), costs.end(), 1.0);
+        total = costs.size();
+    }
+    const double stage_cost = total / n;
+
+    std::vector<std::vector<instruction_ref>> result(1);
+    double cost = 0;
+    for(std::size_t i = 0; i < instructions.size(); i++)
+    {
+        // Start a new stage when most of the instruction's work would go past the current stage
+        if(result.size() < n and not result.back().empty() and
+           cost + costs[i] / 2 > stage_cost * result.size())
+            result.emplace_back();
+        result.back().push_back(instructions[i]);
+        cost += costs[i];
+    }
+    return result;
+}
+
+static std::vector<std::vector<instruction_ref>> find_stages(const module& m,
+                                                             const pipeline_options& options)
+{
+    const auto& cuts = options.cut_points;
+    if(not std::is_sorted(cuts.begin(), cuts.end()) or
+       std::adjacent_find(cuts.begin(), cuts.end()) != cuts.end())
+        MIGRAPHX_THROW("PIPELINE: Cut points must be in increasing order");
+    if(not cuts.empty() and cuts.back() >= m.size())
+        MIGRAPHX_THROW("PIPELINE: Cut point " + std::to_string(cuts.back()) +
+                       " is past the end of the module");
+
+    std::vector<instruction_ref> instructions;
+    std::vector<std::vector<instruction_ref>> result(1);
+    std::size_t index = 0;
+    for(auto ins : iterator_for(m))
+    {
+        if(std::binary_search(cuts.begin(), cuts.end(), index) and not result.back().empty())
+            result.emplace_back();
+        index++;
+        if(starts_with(ins->name(), "@"))
+            continue;
+        if(not ins->module_inputs().empty())
+            MIGRAPHX_THROW("PIPELINE: Submodules are not supported: " + ins->name());
+        instructions.push_back(ins);
+        result.back().push_back(ins);
+    }
+    if(instructions.empty())
+        MIGRAPHX_THROW("PIPELINE: There are no instructions to evaluate");
+    if(cuts.empty())
+    {
+        auto n = std::min(std::max<std::size_t>(options.stages, 1), instructions.size());
+        return balance_stages(instructions, n);
+    }
+    return result;
+}
+
+pipeline::pipeline(const program& p,
+                   const target& t,
+                   pipeline_options options,
+                   compile_options compile)
+    : impl(std::make_unique<pipeline_impl>())
+{
+    const auto* mm = p.get_main_module();
+    impl->t        = t;
+    impl->options  = options;
+
+    std::unordered_map<instruction_ref, std::size_t> ids;
+    auto get_id = [&](instruction_ref ins) {
+        return ids.emplace(ins, ids.size()).first->second;
+    };
+    for(auto ins : iterator_for(*mm))
+    {
+        if(ins->name() == "@param")
+        {
+            auto name = any_cast<builtin::param>(ins->get_operator()).parameter;
+            impl->parameters.emplace_back(name, get_id(ins));
+        }
+    }
+
+    auto groups  = find_stages(*mm, options);
+    auto cores   = available_cores();
+    auto threads = options.threads_per_stage;
+    if(threads == 0)
+        threads = std::max<std::size_t>(1, cores.size() / groups.size());
+    for(std::size_t i = 0; i < groups.size(); i++)
+    {
+        auto mp = make_partition(*mm, groups[i]);
+        mp.prog.compile(t, compile);
+
+        pipeline_stage stage;
+        stage.instructions = groups[i].size();
+        std::transform(
+            mp.inputs.begin(), mp.inputs.end(), std::back_inserter(stage.inputs), get_id);
+        std::transform(
+            mp.outputs.begin(), mp.outputs.end(), std::back_inserter(stage.outputs), get_id);
+        for(std::size_t j = 0; j < threads; j++)
+            stage.cores.push_back(cores[(i * threads + j) % cores.size()]);
+        std::unordered_set<std::string> input_names;
+        for(std::size_t j = 0; j < stage.inputs.size(); j++)
+            input_names.insert(std::to_string(j));
+        for(auto&& ps : mp.prog.get_parameter_shapes())
+        {
+            if(not contains(input_names, ps.first))
+                stage.scratch[ps.first] = t.allocate(ps.second);
+        }
+        stage.prog = std::move(mp.prog);
+        impl->stages.push_back(std::move(stage));
+    }
+
+    auto last = std::prev(mm->end());
+    std::vector<instruction_ref> returns = {last};
+    if(last->name() == "@return")
+        returns = last->inputs();
+    for(auto ins : returns)
+    {
+        pipeline_result r;
+        if(ins->name() == "@literal")
+        {
+            r.constant    = ins->get_literal().get_argument();
+            r.is_constant = true;
+        }
+        else
+        {
+            r.id = get_id(ins);
+        }
+        impl->results.push_back(r);
+    }
+    impl->nvalues = ids.size();
+}
+
+pipeline::~pipeline() = default;
+
+std::size_t pipeline::stages() const { return impl->stages.size(); }
+
+// The outputs of a stage can live in memory that the stage reuses for the next micro batch, so
+// they are copied before being passed on
+static argument take_output(const target& t, const argument& output)
+{
+    auto host = t.copy_from(output);
+    if(host.data() == output.data())
+        return host.copy();
+    return host;
+}
+
+std::vector<std::vector<argument>> pipeline::eval(const std::vector<parameter_map>& batches)
+{
+    using clock   = std::chrono::steady_clock;
+    using ms      = std::chrono::duration<double, std::milli>;
+    const auto n  = impl->stages.size();
+    auto& options = impl->options;
+
+    std::vector<std::vector<argument>> results(batches.size());
+    std::vector<std::unique_ptr<micro_batch_queue>> queues(n);
+    std::generate(queues.begin(), queues.end(), [&] {
+        return std::make_unique<micro_batch_queue>(options.queue_size);
+    });
+    std::vector<std::exception_ptr> errors(n);
+    std::atomic<bool> failed{false};
+    impl->report.assign(n, pipeline_stage_report{});
+
+    auto run_stage = [&](std::size_t i) {
+        auto& stage  = impl->stages[i];
+        auto& report = impl->report[i];
+        report.instructions = stage.instructions;
+        report.threads      = stage.cores.size();
+        try
+        {
+            if(options.pin_threads)
+                pin_thread(stage.cores);
+            // Give the context the thread count of the stage, when the target has one
+            auto& ctx = stage.prog.get_context();
+            auto v    = ctx.to_value();
+            if(v.contains("threads"))
+            {
+                v["threads"] = stage.cores.size();
+                ctx.from_value(v);
+            }
+
+            std::size_t next = 0;
+            for(;;)
+            {
+                auto start = clock::now();
+                micro_batch b;
+                if(i == 0)
+                {
+                    if(next == batches.size())
+                        break;
+                    b.index = next++;
+                    b.values.resize(impl->nvalues);
+                    const auto& params = batches[b.index];
+                    for(auto&& [name, id] : impl->parameters)
+                    {
+                        auto it = params.find(name);
+                        if(it == params.end())
+                            MIGRAPHX_THROW("PIPELINE: Parameter not found: " + name);
+                        b.values[id] = it->second;
+                    }
+                }
+                else if(not queues[i - 1]->pop(b))
+                {
+                    break;
+                }
+                if(failed)
+                    break;
+                auto ready = clock::now();
+
+                parameter_map params = stage.scratch;
+                for(std::size_t j = 0; j < stage.inputs.size(); j++)
+                    params[std::to_string(j)] = impl->t.copy_to(b.values[stage.inputs[j]]);
+                auto outputs = stage.prog.eval(params);
+                for(std::size_t j = 0; j < stage.outputs.size(); j++)
+                    b.values[stage.outputs[j]] = take_output(impl->t, outputs[j]);
+                auto done = clock::now();
+
+                if(i + 1 == n)
+                {
+                    auto& result = results[b.index];
+                    std::transform(impl->results.begin(),
+                                   impl->results.end(),
+                                   std::back_inserter(result),
+                                   [&](const auto& r) {
+                                       return r.is_constant ? r.constant : b.values[r.id];
+                                   });
+                }
+                else if(not queues[i]->push(std::move(b)))
+                {
+                    break;
+                }
+                report.input_wait_ms += ms(ready - start).count();
+                report.busy_ms += ms(done - ready).count();
+                report.output_wait_ms += ms(clock::now() - done).count();
+                report.batches++;
+            }
+        }
+        catch(...)
+        {
+            errors[i] = std::current_exception();
+            failed    = true;
+            for(auto& q : queues)
+                q->close();
+        }
+        queues[i]->close();
+    };
+
+    auto start = clock::now();
+    {
+        std::vector<joinable_thread> threads;
+        threads.reserve(n);
+        for(std::size_t i = 0; i < n; i++)
+            threads.emplace_back(run_stage, i);
+    }
+    auto total = ms(clock::now() - start).count();
+    for(auto& report : impl->report)
+        report.total_ms = total;
+
+    for(const auto& e : errors)
+    {
+        if(e)
+            std::rethrow_exception(e);
+    }
+    return results;
+}
+
+const std::vector<pipeline_stage_report>& pipeline::get_report() const { return impl->report; }
+
+void pipeline::print_report(std::ostream& os) const
+{
+    for(std::size_t i = 0; i < impl->report.size(); i++)
+    {
+        const auto& r = impl->report[i];
+        os << "Stage " << i << ": " << r.instructions << " instructions, " << r.threads
+           << " threads, " << r.batches << " batches, " << r.busy_ms << "ms busy, "
+           << r.input_wait_ms << "ms waiting for input, " << r.output_wait_ms
+           << "ms waiting for output, " << r.utilization() * 100 << "% utilization" << std::endl;
+    }
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
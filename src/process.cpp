@@ -24,39 +24,250 @@
 #include <migraphx/process.hpp>
 #include <migraphx/errors.hpp>
 #include <migraphx/env.hpp>
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
 #include <functional>
 #include <iostream>
+#include <iterator>
+#include <mutex>
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/wait.h>
 #include <unistd.h>
 
+extern char** environ; // NOLINT
+
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
 MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_CMD_EXECUTE)
 
-std::function<void(const char*)> redirect_to(std::ostream& os)
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+#define MIGRAPHX_HAS_SPAWN_CHDIR 1
+#else
+#define MIGRAPHX_HAS_SPAWN_CHDIR 0
+#endif
+
+std::vector<std::string> split_command(const std::string& cmd)
 {
-    return [&](const char* x) { os << x; };
+    std::vector<std::string> result;
+    std::string arg;
+    bool in_arg = false;
+    char quote  = 0;
+    for(auto it = cmd.begin(); it != cmd.end(); ++it)
+    {
+        char c = *it;
+        if(quote == '\'')
+        {
+            if(c == '\'')
+                quote = 0;
+            else
+                arg += c;
+        }
+        else if(c == '\\' and std::next(it) != cmd.end() and
+                (quote == 0 or std::string{"\\\"$`"}.find(*std::next(it)) != std::string::npos))
+        {
+            arg += *(++it);
+            in_arg = true;
+        }
+        else if(quote == '"')
+        {
+            if(c == '"')
+                quote = 0;
+            else
+                arg += c;
+        }
+        else if(c == '\'' or c == '"')
+        {
+            quote  = c;
+            in_arg = true;
+        }
+        else if(std::isspace(static_cast<unsigned char>(c)) != 0)
+        {
+            if(in_arg)
+                result.push_back(arg);
+            arg.clear();
+            in_arg = false;
+        }
+        else
+        {
+            arg += c;
+            in_arg = true;
+        }
+    }
+    if(quote != 0)
+        MIGRAPHX_THROW("Unterminated quote in command: " + cmd);
+    if(in_arg)
+        result.push_back(arg);
+    return result;
 }
 
-int exec(const std::string& cmd, const std::function<void(const char*)>& std_out)
+using writer = std::function<void(const char*, std::size_t)>;
+
+// Forwards complete lines to a stream, so output from commands running on
+// different threads does not interleave within a line
+struct line_writer
+{
+    std::ostream* os;
+    std::string buffer = {};
+
+    static std::mutex& get_mutex()
+    {
+        static std::mutex m;
+        return m;
+    }
+
+    void write(const char* data, std::size_t n)
+    {
+        buffer.append(data, n);
+        auto last = buffer.rfind('\n');
+        if(last == std::string::npos)
+            return;
+        std::lock_guard<std::mutex> lock(get_mutex());
+        os->write(buffer.data(), last + 1);
+        os->flush();
+        buffer.erase(0, last + 1);
+    }
+
+    ~line_writer()
+    {
+        if(buffer.empty())
+            return;
+        std::lock_guard<std::mutex> lock(get_mutex());
+        *os << buffer << std::endl;
+    }
+};
+
+struct fd_pipe
 {
-    int ec = 0;
-    if(enabled(MIGRAPHX_TRACE_CMD_EXECUTE{}))
-        std::cout << cmd << std::endl;
-    auto closer = [&](FILE* stream) {
-        auto status = pclose(stream);
-        ec          = WIFEXITED(status) ? 0 : WEXITSTATUS(status); // NOLINT
-    };
+    std::array<int, 2> fds = {{-1, -1}};
+
+    fd_pipe()
+    {
+        if(pipe2(fds.data(), O_CLOEXEC) != 0)
+            MIGRAPHX_THROW("Failed to create pipe: " + std::string{std::strerror(errno)});
+    }
+
+    fd_pipe(const fd_pipe&) = delete;
+    fd_pipe& operator=(const fd_pipe&) = delete;
+
+    int read_end() const { return fds[0]; }
+    int write_end() const { return fds[1]; }
+
+    void close_write()
+    {
+        if(fds[1] >= 0)
+            close(fds[1]);
+        fds[1] = -1;
+    }
+
+    ~fd_pipe()
     {
-        // TODO: Use execve instead of popen
-        std::unique_ptr<FILE, decltype(closer)> pipe(popen(cmd.c_str(), "r"), closer); // NOLINT
-        if(not pipe)
-            MIGRAPHX_THROW("popen() failed: " + cmd);
-        std::array<char, 128> buffer;
-        while(fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr)
-            std_out(buffer.data());
+        for(auto fd : fds)
+        {
+            if(fd >= 0)
+                close(fd);
+        }
+    }
+};
+
+struct spawn_actions
+{
+    posix_spawn_file_actions_t actions{};
+    spawn_actions() { posix_spawn_file_actions_init(&actions); }
+    spawn_actions(const spawn_actions&) = delete;
+    spawn_actions& operator=(const spawn_actions&) = delete;
+    ~spawn_actions() { posix_spawn_file_actions_destroy(&actions); }
+};
+
+// Read from both pipes until they are closed, without letting either one
+// fill up and stall the child
+static void stream_output(int out, int err, const writer& std_out, const writer& std_err)
+{
+    std::array<pollfd, 2> fds = {{{out, POLLIN, 0}, {err, POLLIN, 0}}};
+    std::array<const writer*, 2> writers = {{&std_out, &std_err}};
+    std::array<char, 4096> buffer;
+    std::size_t open_fds = fds.size();
+    while(open_fds > 0)
+    {
+        if(poll(fds.data(), fds.size(), -1) < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            MIGRAPHX_THROW("poll() failed: " + std::string{std::strerror(errno)});
+        }
+        for(std::size_t i = 0; i < fds.size(); i++)
+        {
+            if(fds[i].fd < 0 or fds[i].revents == 0)
+                continue;
+            auto n = ::read(fds[i].fd, buffer.data(), buffer.size());
+            if(n > 0)
+            {
+                (*writers[i])(buffer.data(), n);
+            }
+            else if(n == 0 or errno != EINTR)
+            {
+                // A negative fd is ignored by poll
+                fds[i].fd = -1;
+                open_fds--;
+            }
+        }
     }
-    return ec;
+}
+
+static int exec(const std::vector<std::string>& args,
+                const fs::path& cwd,
+                const writer& std_out,
+                const writer& std_err)
+{
+    std::vector<std::string> cmd_args = args;
+#if !MIGRAPHX_HAS_SPAWN_CHDIR
+    // Without posix_spawn_file_actions_addchdir_np let the shell change the
+    // directory, passing the arguments through unchanged
+    if(not cwd.empty())
+    {
+        cmd_args = {"/bin/sh", "-c", "cd \"$0\" && exec \"$@\"", cwd.string()};
+        cmd_args.insert(cmd_args.end(), args.begin(), args.end());
+    }
+#endif
+    std::vector<char*> argv;
+    std::transform(cmd_args.begin(), cmd_args.end(), std::back_inserter(argv), [](auto& s) {
+        return const_cast<char*>(s.c_str()); // NOLINT
+    });
+    argv.push_back(nullptr);
+
+    fd_pipe out;
+    fd_pipe err;
+    spawn_actions sa;
+    posix_spawn_file_actions_adddup2(&sa.actions, out.write_end(), STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&sa.actions, err.write_end(), STDERR_FILENO);
+#if MIGRAPHX_HAS_SPAWN_CHDIR
+    if(not cwd.empty())
+        posix_spawn_file_actions_addchdir_np(&sa.actions, cwd.c_str());
+#endif
+    pid_t pid = 0;
+    auto ec   = posix_spawnp(&pid, argv.front(), &sa.actions, nullptr, argv.data(), environ);
+    if(ec != 0)
+        MIGRAPHX_THROW("Failed to run " + args.front() + ": " + std::strerror(ec));
+    out.close_write();
+    err.close_write();
+    stream_output(out.read_end(), err.read_end(), std_out, std_err);
+
+    int status = 0;
+    while(waitpid(pid, &status, 0) < 0)
+    {
+        if(errno != EINTR)
+            MIGRAPHX_THROW("waitpid() failed: " + std::string{std::strerror(errno)});
+    }
+    if(WIFEXITED(status))          // NOLINT
+        return WEXITSTATUS(status); // NOLINT
+    if(WIFSIGNALED(status))         // NOLINT
+        return 128 + WTERMSIG(status); // NOLINT
+    return -1;
 }
 
 struct process_impl
@@ -72,6 +283,19 @@ struct process_impl
         result += command;
         return result;
     }
+
+    void run(const writer& std_out, const writer& std_err) const
+    {
+        if(enabled(MIGRAPHX_TRACE_CMD_EXECUTE{}))
+            std::cout << get_command() << std::endl;
+        auto args = split_command(command);
+        if(args.empty())
+            MIGRAPHX_THROW("Empty command");
+        auto ec = migraphx::exec(args, cwd, std_out, std_err);
+        if(ec != 0)
+            MIGRAPHX_THROW("Command " + get_command() + " exited with status " +
+                           std::to_string(ec));
+    }
 };
 
 process::process(const std::string& cmd) : impl(std::make_unique<process_impl>())
@@ -97,10 +321,19 @@ process& process::cwd(const fs::path& p)
 
 void process::exec()
 {
-    auto ec = migraphx::exec(impl->get_command(), redirect_to(std::cout));
-    if(ec != 0)
-        MIGRAPHX_THROW("Command " + impl->get_command() + " exited with status " +
-                       std::to_string(ec));
+    line_writer out{&std::cout};
+    line_writer err{&std::cerr};
+    impl->run([&](const char* x, std::size_t n) { out.write(x, n); },
+              [&](const char* x, std::size_t n) { err.write(x, n); });
+}
+
+std::string process::read()
+{
+    std::string result;
+    line_writer err{&std::cerr};
+    impl->run([&](const char* x, std::size_t n) { result.append(x, n); },
+              [&](const char* x, std::size_t n) { err.write(x, n); });
+    return result;
 }
 
 } // namespace MIGRAPHX_INLINE_NS
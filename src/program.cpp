@@ -24,6 +24,7 @@
 #include <migraphx/program.hpp>
 #include <migraphx/stringutils.hpp>
 #include <migraphx/instruction.hpp>
+#include <migraphx/eval_plan.hpp>
 #include <migraphx/op/identity.hpp>
 #include <migraphx/target.hpp>
 #include <migraphx/env.hpp>
@@ -38,6 +39,7 @@
 #include <migraphx/make_op.hpp>
 #include <migraphx/marker.hpp>
 #include <migraphx/supported_segments.hpp>
+#include <migraphx/perf_counters.hpp>
 #include <iostream>
 #include <sstream>
 #include <algorithm>
@@ -45,7 +47,10 @@
 #include <utility>
 
 #include <unordered_set>
+#include <unordered_map>
 #include <map>
+#include <deque>
+#include <limits>
 #include <cassert>
 
 namespace migraphx {
@@ -168,37 +173,48 @@ target_assignments program::get_target_assignments(const std::vector<target>& ta
     target_assignments p;
 
     const auto* mod = get_main_module();
-    std::vector<std::pair<target, supported_segments>> target_subgraphs;
-    target_subgraphs.reserve(targets.size());
-    std::transform(targets.begin(),
-                   targets.end(),
-                   std::back_inserter(target_subgraphs),
-                   [&](const auto& t) { return std::make_pair(t, t.find_supported(mod, m)); });
-
-    for(const auto ins : iterator_for(*mod))
+    // Cost of each instruction on each target, taken from the cheapest segment that contains it
+    std::vector<std::unordered_map<instruction_ref, float>> costs(targets.size());
+    for(std::size_t i = 0; i < targets.size(); i++)
     {
-        if(contains(p, ins))
+        for(const auto& segment : targets[i].find_supported(mod, m))
         {
-            continue;
+            for(auto ins : segment.instructions)
+            {
+                auto it = costs[i].find(ins);
+                if(it == costs[i].end() or segment.metric < it->second)
+                    costs[i][ins] = segment.metric;
+            }
         }
+    }
 
-        for(const auto& [target, subgraph] : target_subgraphs)
+    for(const auto ins : iterator_for(*mod))
+    {
+        std::size_t best_target = targets.size();
+        float best_cost         = std::numeric_limits<float>::max();
+        for(std::size_t i = 0; i < targets.size(); i++)
         {
-            // can't pass a structured binding into lambda in C++17 so create a variable for it
-            const auto& t = target;
-            for(const auto& segment : subgraph)
+            auto it = costs[i].find(ins);
+            if(it == costs[i].end())
+                continue;
+            // Inputs assigned to another target have to be copied over to this one
+            float cost = it->second;
+            for(auto input : ins->inputs())
             {
-                const auto& instructions = segment.instructions;
-                if(not contains(instructions, ins))
-                {
+                auto a = p.find(input);
+                if(a == p.end() or a->second == targets[i].name())
                     continue;
-                }
-                std::transform(instructions.begin(),
-                               instructions.end(),
-                               std::inserter(p, p.end()),
-                               [&](auto instr) { return std::make_pair(instr, t.name()); });
+                cost += options.transfer_cost * input->get_shape().bytes();
+            }
+            // Ties go to the target listed first
+            if(cost < best_cost)
+            {
+                best_cost   = cost;
+                best_target = i;
             }
         }
+        if(best_target < targets.size())
+            p.insert(p.end(), std::make_pair(ins, targets[best_target].name()));
     }
     return p;
 }
@@ -304,6 +320,185 @@ void preview_argument(std::ostream& os, const argument& a)
         });
 }
 
+// Finds the results of enclosing modules, which submodules may use directly
+struct eval_frame
+{
+    const eval_plan* plan                                       = nullptr;
+    const std::vector<argument>* results                        = nullptr;
+    const std::unordered_map<instruction_ref, argument>* outer = nullptr;
+    const eval_frame* parent                                    = nullptr;
+
+    const argument& get(instruction_ref ins) const
+    {
+        for(const auto* f = this; f != nullptr; f = f->parent)
+        {
+            if(f->plan != nullptr)
+            {
+                auto it = f->plan->slots.find(ins);
+                if(it != f->plan->slots.end())
+                    return (*f->results)[it->second];
+            }
+            else if(f->outer != nullptr)
+            {
+                auto it = f->outer->find(ins);
+                if(it != f->outer->end())
+                    return it->second;
+            }
+        }
+        MIGRAPHX_THROW("No result for instruction: " + ins->name());
+    }
+
+    std::unordered_map<instruction_ref, argument> collect() const
+    {
+        std::unordered_map<instruction_ref, argument> result;
+        for(const auto* f = this; f != nullptr; f = f->parent)
+        {
+            if(f->plan != nullptr)
+            {
+                for(const auto& p : f->plan->slots)
+                    result.emplace(p.first, (*f->results)[p.second]);
+            }
+            else if(f->outer != nullptr)
+            {
+                result.insert(f->outer->begin(), f->outer->end());
+            }
+        }
+        return result;
+    }
+};
+
+// Result storage reused by every evaluation on a thread, so evaluating a
+// finalized module doesn't allocate once it has run. There is a level for
+// each submodule being evaluated, and a deque keeps the levels in place as
+// it grows.
+struct eval_scratch
+{
+    std::deque<std::vector<argument>> results;
+    std::deque<std::vector<argument>> inputs;
+    std::size_t depth = 0;
+
+    static eval_scratch& get()
+    {
+        thread_local eval_scratch scratch;
+        return scratch;
+    }
+};
+
+struct eval_scratch_level
+{
+    eval_scratch& scratch;
+    std::size_t n;
+    std::vector<argument>& results;
+    std::vector<argument>& inputs;
+
+    eval_scratch_level(eval_scratch& s, std::size_t size)
+        : scratch(s), n(size), results(level(s.results, s.depth)), inputs(level(s.inputs, s.depth))
+    {
+        scratch.depth++;
+        if(results.size() < n)
+            results.resize(n);
+    }
+
+    static std::vector<argument>& level(std::deque<std::vector<argument>>& levels, std::size_t d)
+    {
+        if(levels.size() <= d)
+            levels.resize(d + 1);
+        return levels[d];
+    }
+
+    eval_scratch_level(const eval_scratch_level&) = delete;
+    eval_scratch_level& operator=(const eval_scratch_level&) = delete;
+
+    ~eval_scratch_level()
+    {
+        // Release the buffers without giving up the capacity
+        std::fill(results.begin(), results.begin() + n, argument{});
+        std::fill(inputs.begin(), inputs.end(), argument{});
+        scratch.depth--;
+    }
+};
+
+template <class F>
+std::vector<argument> generic_eval(const module* mod,
+                                   context& ctx,
+                                   std::unordered_map<std::string, argument> params,
+                                   std::unordered_map<instruction_ref, argument> results,
+                                   F make_trace);
+
+template <class F>
+std::vector<argument> plan_eval(const module* mod,
+                                const eval_plan& plan,
+                                context& ctx,
+                                const std::unordered_map<std::string, argument>& params,
+                                const eval_frame* parent,
+                                F make_trace)
+{
+    eval_scratch_level level{eval_scratch::get(), plan.steps.size()};
+    auto& results = level.results;
+    auto& values  = level.inputs;
+    eval_frame frame{&plan, &results, nullptr, parent};
+    auto trace     = make_trace(mod);
+    auto get_input = [&](const eval_step& step, std::size_t j) -> const argument& {
+        auto slot = step.inputs[j];
+        if(slot != eval_step::outer)
+            return results[slot];
+        if(parent == nullptr)
+            MIGRAPHX_THROW("No result for instruction: " + step.ins->inputs()[j]->name());
+        return parent->get(step.ins->inputs()[j]);
+    };
+    auto run_submodule = [&](module_ref smod,
+                             const std::unordered_map<std::string, argument>& inputs) {
+        if(const auto* splan = smod->get_eval_plan())
+            return plan_eval(smod, *splan, ctx, inputs, &frame, make_trace);
+        return generic_eval(smod, ctx, inputs, frame.collect(), make_trace);
+    };
+    // Capturing a single reference lets std::function store this without allocating
+    auto module_eval = [&run_submodule](module_ref smod,
+                                        const std::unordered_map<std::string, argument>& inputs) {
+        return run_submodule(smod, inputs);
+    };
+    for(std::size_t i = 0; i < plan.steps.size(); i++)
+    {
+        const auto& step = plan.steps[i];
+        auto ins         = step.ins;
+        switch(step.kind)
+        {
+        case eval_step::constant: results[i] = trace(ins, [&] { return step.value; }); break;
+        case eval_step::parameter:
+            results[i] = trace(ins, [&] {
+                auto it = params.find(step.param);
+                if(it == params.end())
+                    MIGRAPHX_THROW("Parameter not found: " + step.param);
+                if(not ins->get_shape().dynamic() and it->second.get_shape() != ins->get_shape())
+                {
+                    MIGRAPHX_THROW("Incorrect shape {" + to_string(it->second.get_shape()) +
+                                   "} for parameter: " + step.param);
+                }
+                return it->second;
+            });
+            break;
+        case eval_step::returns: {
+            std::vector<argument> prog_outputs(step.inputs.size());
+            for(std::size_t j = 0; j < step.inputs.size(); j++)
+                prog_outputs[j] = get_input(step, j);
+            return prog_outputs;
+        }
+        case eval_step::compute: {
+            values.resize(step.inputs.size());
+            for(std::size_t j = 0; j < step.inputs.size(); j++)
+                values[j] = get_input(step, j);
+            results[i] = trace(ins, [&] {
+                return step.op.compute(
+                    ctx, ins->get_shape(), values, ins->module_inputs(), module_eval);
+            });
+            break;
+        }
+        }
+        assert(ins->get_shape().dynamic() or results[i].get_shape() == ins->get_shape());
+    }
+    return {results[plan.steps.size() - 1]};
+}
+
 template <class F>
 std::vector<argument> generic_eval(const module* mod,
                                    context& ctx,
@@ -312,6 +507,11 @@ std::vector<argument> generic_eval(const module* mod,
                                    F make_trace)
 {
     assert(mod->validate() == mod->end());
+    if(const auto* plan = mod->get_eval_plan())
+    {
+        eval_frame outer{nullptr, nullptr, &results, nullptr};
+        return plan_eval(mod, *plan, ctx, params, &outer, make_trace);
+    }
     results.reserve(mod->size() * 2);
     std::vector<argument> values;
     values.reserve(16);
@@ -391,10 +591,12 @@ std::vector<argument> generic_eval(const module* mod,
 template <class F>
 std::vector<argument> generic_eval(const program& p,
                                    context& ctx,
-                                   std::unordered_map<std::string, argument> params,
+                                   const std::unordered_map<std::string, argument>& params,
                                    F make_trace)
 {
     const module* mm = p.get_main_module();
+    if(const auto* plan = mm->get_eval_plan())
+        return plan_eval(mm, *plan, ctx, params, nullptr, make_trace);
     return generic_eval(mm, ctx, params, {}, make_trace);
 }
 
@@ -510,7 +712,7 @@ value program::to_value() const
         value nodes;
         mod_val["name"] = mod->name();
         names           = mod->print(
-            [&](auto ins, auto ins_names) {
+            [&](auto ins, const auto& ins_names) {
                 value node;
                 node["output"]     = ins_names.at(ins);
                 node["name"]       = ins->name();
@@ -691,10 +893,28 @@ void program::mark(const parameter_map& params, marker&& m)
     m.mark_stop(*this);
 }
 
+static double giga_per_second(double x, double ms) { return ms > 0 ? x / ms / 1.0e6 : 0.0; }
+
+static void print_rates(std::ostream& os, double flops, double bytes, double ms)
+{
+    if(flops > 0)
+        os << ", " << giga_per_second(flops, ms) << " GFLOP/s";
+    if(bytes > 0)
+        os << ", " << giga_per_second(bytes, ms) << " GB/s";
+}
+
+// The counters are summed over n runs that each took ms on average
+static void print_counters(std::ostream& os, const perf_counter_values& c, std::size_t n, double ms)
+{
+    os << ", " << c.cycles / n << " cycles, IPC " << c.ipc() << ", " << c.cache_misses / n
+       << " LLC misses, " << giga_per_second(c.memory_bytes() / n, ms) << " GB/s measured";
+}
+
 void program::perf_report(std::ostream& os,
                           std::size_t n,
                           parameter_map params,
-                          std::size_t batch) const
+                          std::size_t batch,
+                          const perf_options& options) const
 {
     auto& ctx = this->impl->ctx;
     // Run once by itself
@@ -732,6 +952,27 @@ void program::perf_report(std::ostream& os,
     }
     for(auto&& p : ins_vec)
         std::sort(p.second.begin(), p.second.end());
+    // Read the hardware counters in separate runs, so reading them isn't part of the times. They
+    // are opened after the runs above, so the thread pools those started are counted too.
+    std::unordered_map<instruction_ref, perf_counter_values> ins_counters;
+    if(options.counters)
+    {
+        perf_counters counters;
+        if(not counters.available())
+            os << "Hardware counters are not available" << std::endl;
+        else
+            os << "Hardware counters of " << counters.threads() << " threads" << std::endl;
+        for(std::size_t i = 0; i < n and counters.available(); i++)
+        {
+            generic_eval(*this, ctx, params, always([&](auto ins, auto f) {
+                counters.start();
+                argument result = f();
+                ctx.finish();
+                ins_counters[ins] += counters.stop();
+                return result;
+            }));
+        }
+    }
     // Run and time implicit overhead
     std::vector<double> overhead_vec;
     overhead_vec.reserve(n);
@@ -745,21 +986,37 @@ void program::perf_report(std::ostream& os,
     double overhead_time          = common_average(overhead_vec);
     double overhead_percent       = overhead_time * 100.0 / total_time;
     double total_instruction_time = 0.0;
+    double total_flops            = 0.0;
+    double total_bytes            = 0.0;
     std::unordered_map<std::string, double> op_times;
     std::unordered_map<std::string, std::size_t> op_n;
+    std::unordered_map<std::string, double> op_flops;
+    std::unordered_map<std::string, double> op_bytes;
+    std::unordered_map<std::string, perf_counter_values> op_counters;
+    perf_counter_values total_counters;
     for(auto&& p : ins_vec)
     {
         double avg = common_average(p.second);
-        op_times[perf_group(p.first->get_operator())] += avg;
+        auto group = perf_group(p.first->get_operator());
+        op_times[group] += avg;
         total_instruction_time += avg;
-        op_n[perf_group(p.first->get_operator())]++;
+        op_n[group]++;
+        op_flops[group] += estimate_flops(p.first);
+        op_bytes[group] += estimate_bytes(p.first);
+        total_flops += estimate_flops(p.first);
+        total_bytes += estimate_bytes(p.first);
+        if(contains(ins_counters, p.first))
+        {
+            op_counters[group] += ins_counters.at(p.first);
+            total_counters += ins_counters.at(p.first);
+        }
     }
     double calculate_overhead_time    = total_time - total_instruction_time;
     double calculate_overhead_percent = calculate_overhead_time * 100.0 / total_time;
 
     std::unordered_map<instruction_ref, std::string> names;
     this->print(names, [&](auto ins, auto ins_names) {
-        instruction::print(std::cout, ins, ins_names);
+        instruction::print(os, ins, ins_names);
 
         // skip return instruction
         if(ins->name() == "@return")
@@ -768,6 +1025,9 @@ void program::perf_report(std::ostream& os,
         double avg     = common_average(ins_vec[ins]);
         double percent = std::ceil(100.0 * avg / total_instruction_time);
         os << ": " << avg << "ms, " << percent << "%";
+        print_rates(os, estimate_flops(ins), estimate_bytes(ins), avg);
+        if(contains(ins_counters, ins))
+            print_counters(os, ins_counters.at(ins), n, avg);
         os << std::endl;
     });
 
@@ -784,9 +1044,51 @@ void program::perf_report(std::ostream& os,
     {
         double percent = std::ceil(100.0 * avg / total_instruction_time);
         double per_ins = avg / nn;
-        os << name << ": " << avg << "ms / " << nn << " = " << per_ins << "ms, " << percent << "%"
-           << std::endl;
+        os << name << ": " << avg << "ms / " << nn << " = " << per_ins << "ms, " << percent << "%";
+        if(contains(op_counters, name))
+            print_counters(os, op_counters.at(name), n * nn, per_ins);
+        os << std::endl;
+    }
+
+    os << std::endl;
+    os << "Roofline:" << std::endl;
+    auto print_roofline = [&](const std::string& name,
+                              double flops,
+                              double bytes,
+                              double ms,
+                              const perf_counter_values* c) {
+        if(flops == 0 and bytes == 0)
+            return;
+        os << name << ": " << giga_per_second(flops, ms) << " GFLOP/s, "
+           << giga_per_second(bytes, ms) << " GB/s";
+        // The bytes estimated from the shapes assume every access goes to memory, while the
+        // cache misses show the traffic that actually did
+        if(c != nullptr)
+            os << " (" << giga_per_second(c->memory_bytes() / n, ms) << " GB/s measured)";
+        if(bytes > 0)
+            os << ", " << flops / bytes << " FLOP/byte";
+        if(options.peak_gflops > 0 and options.peak_gbs > 0 and bytes > 0)
+        {
+            double intensity  = flops / bytes;
+            double attainable = std::min(options.peak_gflops, intensity * options.peak_gbs);
+            bool memory_bound = intensity < options.peak_gflops / options.peak_gbs;
+            double efficiency = flops > 0 ? giga_per_second(flops, ms) / attainable
+                                          : giga_per_second(bytes, ms) / options.peak_gbs;
+            os << ", " << (memory_bound ? "memory" : "compute") << " bound, "
+               << std::round(100.0 * efficiency) << "% of roof";
+        }
+        os << std::endl;
+    };
+    for(auto&& [avg, nn, name] : op_times_sorted)
+    {
+        const auto* c = contains(op_counters, name) ? &op_counters.at(name) : nullptr;
+        print_roofline(name, op_flops.at(name), op_bytes.at(name), avg, c);
     }
+    print_roofline("Total",
+                   total_flops,
+                   total_bytes,
+                   total_instruction_time,
+                   ins_counters.empty() ? nullptr : &total_counters);
 
     os << std::endl;
 
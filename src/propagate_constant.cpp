@@ -27,6 +27,11 @@
 #include <migraphx/literal.hpp>
 #include <migraphx/functional.hpp>
 #include <migraphx/par_for.hpp>
+#include <migraphx/ranges.hpp>
+#include <algorithm>
+#include <numeric>
+#include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace migraphx {
@@ -46,40 +51,144 @@ bool skip_propogate(instruction_ref ins)
 
 bool is_const(instruction_ref ins) { return ins->can_eval() and not skip_propogate(ins); }
 
+// Bytes of the tensor when all its elements are stored
+static std::size_t tensor_bytes(const shape& s)
+{
+    if(s.type() == shape::tuple_type)
+        return s.bytes();
+    return s.elements() * s.type_size();
+}
+
+// Bytes of the data behind each constant instruction. Broadcasted views and the instructions that
+// are not folded only have the data of their inputs.
+struct const_data
+{
+    std::unordered_map<instruction_ref, std::size_t> bytes;
+
+    std::size_t get(instruction_ref ins)
+    {
+        if(ins->name() == "@literal")
+            return ins->get_shape().bytes();
+        auto it = bytes.find(ins);
+        if(it != bytes.end())
+            return it->second;
+        std::size_t result = ins->get_shape().bytes();
+        if(not can_fold(ins))
+            result = std::min(result, inputs_bytes(ins));
+        bytes[ins] = result;
+        return result;
+    }
+
+    std::size_t inputs_bytes(instruction_ref ins)
+    {
+        return std::accumulate(ins->inputs().begin(),
+                               ins->inputs().end(),
+                               std::size_t{0},
+                               [&](auto x, auto input) { return x + get(input); });
+    }
+
+    // Don't fold an instruction that makes its broadcasted inputs larger, such as an add of two
+    // multibroadcasted scalars
+    bool expands(instruction_ref ins)
+    {
+        bool broadcasted = std::any_of(ins->inputs().begin(), ins->inputs().end(), [&](auto input) {
+            return get(input) < tensor_bytes(input->get_shape());
+        });
+        return broadcasted and ins->get_shape().bytes() > inputs_bytes(ins);
+    }
+
+    bool can_fold(instruction_ref ins) { return is_const(ins) and not expands(ins); }
+};
+
+// Shares the literals with the same contents
+struct literal_cache
+{
+    std::unordered_map<std::size_t, std::vector<instruction_ref>> literals;
+
+    static std::size_t hash(const literal& l)
+    {
+        std::size_t result = std::hash<std::string_view>{}({l.data(), l.get_shape().bytes()});
+        return result ^ std::hash<std::string>{}(l.get_shape().type_string());
+    }
+
+    instruction_ref add(module& m, literal l)
+    {
+        auto& same_hash = literals[hash(l)];
+        auto it         = std::find_if(same_hash.begin(), same_hash.end(), [&](auto ins) {
+            const auto& x = ins->get_literal();
+            return x.get_shape() == l.get_shape() and
+                   std::equal(x.data(), x.data() + x.get_shape().bytes(), l.data());
+        });
+        if(it != same_hash.end())
+            return *it;
+        same_hash.push_back(m.add_literal(std::move(l)));
+        return same_hash.back();
+    }
+};
+
 void propagate_constant::apply(module& m) const
 {
     std::unordered_set<instruction_ref> const_instrs;
+    const_data data;
     auto last = std::prev(m.end());
 
     // Find instructions that can be evaluated to a literal
     for(auto i : iterator_for(m))
     {
-        if(is_const(i) and i != last)
+        if(data.can_fold(i) and i != last)
             continue;
 
-        std::copy_if(
-            i->inputs().begin(),
-            i->inputs().end(),
-            std::inserter(const_instrs, const_instrs.begin()),
-            [&](const instruction_ref ins) { return is_const(ins) and ins->name() != "@literal"; });
+        std::copy_if(i->inputs().begin(),
+                     i->inputs().end(),
+                     std::inserter(const_instrs, const_instrs.begin()),
+                     [&](const instruction_ref ins) {
+                         return data.can_fold(ins) and ins->name() != "@literal";
+                     });
     }
 
-    // Compute literals in parallel
-    std::vector<instruction_ref> const_instrs_vec{const_instrs.begin(), const_instrs.end()};
-    std::vector<argument> literals(const_instrs_vec.size());
-    par_for(const_instrs_vec.size(), 1, [&](const auto i) {
-        literals[i] = const_instrs_vec[i]->eval();
-    });
+    // Keep the order of the module, so the folding is deterministic
+    std::vector<instruction_ref> const_instrs_vec;
+    for(auto ins : iterator_for(m))
+    {
+        if(contains(const_instrs, ins))
+            const_instrs_vec.push_back(ins);
+    }
 
-    // Replace instructions in m
-    for(size_t i = 0; i < const_instrs_vec.size(); i++)
+    // Compute literals in parallel, in batches that fit in the memory budget
+    literal_cache cache;
+    std::size_t start = 0;
+    while(start < const_instrs_vec.size())
     {
-        if(not literals[i].empty())
+        std::size_t bytes = 0;
+        std::size_t end   = start;
+        while(end < const_instrs_vec.size())
+        {
+            bytes += const_instrs_vec[end]->get_shape().bytes();
+            if(end > start and memory_budget > 0 and bytes > memory_budget)
+                break;
+            end++;
+        }
+        std::vector<argument> literals(end - start);
+        par_for(literals.size(), 1, [&](const auto i) {
+            literals[i] = const_instrs_vec[start + i]->eval();
+        });
+
+        // Replace instructions in m
+        for(std::size_t i = 0; i < literals.size(); i++)
         {
-            assert(literals[i].get_shape() == const_instrs_vec[i]->get_shape());
-            auto l = m.add_literal(literals[i].get_shape(), literals[i].data());
-            m.replace_instruction(const_instrs_vec[i], l);
+            if(literals[i].empty())
+                continue;
+            auto ins = const_instrs_vec[start + i];
+            assert(literals[i].get_shape() == ins->get_shape());
+            // The result of an operator that doesn't alias its inputs owns its whole buffer, so
+            // it can be moved into the literal
+            auto alias = ins->get_operator().output_alias(to_shapes(ins->inputs()));
+            auto l     = alias < 0 ? literal{literals[i]}
+                                   : literal{literals[i].get_shape(), literals[i].data()};
+            literals[i] = {};
+            m.replace_instruction(ins, cache.add(m, std::move(l)));
         }
+        start = end;
     }
 }
 
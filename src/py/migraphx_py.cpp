@@ -40,7 +40,10 @@
 #include <migraphx/register_target.hpp>
 #include <migraphx/json.hpp>
 #include <migraphx/make_op.hpp>
+#include <migraphx/ranges.hpp>
 #include <migraphx/op/common.hpp>
+#include <mutex>
+#include <unordered_map>
 
 #ifdef HAVE_GPU
 #include <migraphx/gpu/hip.hpp>
@@ -234,6 +237,155 @@ migraphx::shape to_shape(const py::buffer_info& info)
     }
 }
 
+migraphx::argument to_input_argument(const py::buffer_info& info, const migraphx::shape& expected)
+{
+    auto s = to_shape(info);
+    migraphx::argument arg{s, info.ptr};
+    // Bind the buffer directly when its layout matches, otherwise copy it
+    // into the layout the program expects
+    if(s == expected or s.type() != expected.type() or s.lens() != expected.lens())
+        return arg;
+    migraphx::argument result{expected};
+    visit_all(result, arg)(
+        [](auto output, auto input) { std::copy(input.begin(), input.end(), output.begin()); });
+    return result;
+}
+
+std::string output_parameter_name(const std::unordered_map<std::string, migraphx::shape>& params,
+                                  std::size_t i)
+{
+    auto name = "main:#output_" + std::to_string(i);
+    if(migraphx::contains(params, name))
+        return name;
+    if(i == 0 and migraphx::contains(params, "output"))
+        return "output";
+    return "";
+}
+
+// A compiled program reuses its scratch memory and context on every eval, so
+// runs of the same program from several Python threads take turns. The mutex
+// is kept on the python object, so it lives as long as the program does.
+std::mutex& program_mutex(const py::object& self)
+{
+    if(not py::hasattr(self, "_run_mutex"))
+        self.attr("_run_mutex") =
+            py::capsule(new std::mutex, [](void* x) { delete static_cast<std::mutex*>(x); });
+    std::mutex* result = self.attr("_run_mutex").cast<py::capsule>();
+    return *result;
+}
+
+// The outputs that live in the preallocated scratch memory of a host target,
+// which the next run overwrites
+std::vector<bool> scratch_outputs(const migraphx::program& p)
+{
+    const auto* mm = p.get_main_module();
+    if(mm->begin() == mm->end())
+        return {};
+    auto last = std::prev(mm->end());
+    std::vector<migraphx::instruction_ref> outputs{last};
+    if(last->name() == "@return")
+        outputs = last->inputs();
+    std::vector<bool> result;
+    std::transform(outputs.begin(),
+                   outputs.end(),
+                   std::back_inserter(result),
+                   [](migraphx::instruction_ref ins) {
+                       auto alias = migraphx::instruction::get_output_alias(ins);
+                       return ends_with(alias->name(), "::preallocate");
+                   });
+    return result;
+}
+
+std::vector<migraphx::argument> run_program(const py::object& self,
+                                            const py::dict& params,
+                                            const py::object& outputs,
+                                            const migraphx::execution_environment& exec_env)
+{
+    const auto& p     = self.cast<const migraphx::program&>();
+    auto param_shapes = p.get_parameter_shapes();
+    // The requested buffers keep the python objects alive while the GIL is
+    // released
+    std::vector<py::buffer_info> infos;
+    infos.reserve(params.size());
+    migraphx::parameter_map pm;
+    for(auto x : params)
+    {
+        std::string key = x.first.cast<std::string>();
+        infos.push_back(x.second.cast<py::buffer>().request());
+        const auto& info = infos.back();
+        auto it          = param_shapes.find(key);
+        if(it == param_shapes.end())
+            pm[key] = migraphx::argument(to_shape(info), info.ptr);
+        else
+            pm[key] = to_input_argument(info, it->second);
+    }
+
+    std::vector<migraphx::argument> output_args;
+    if(not outputs.is_none())
+    {
+        auto output_shapes = p.get_output_shapes();
+        auto buffers       = outputs.cast<std::vector<py::buffer>>();
+        if(buffers.size() != output_shapes.size())
+            MIGRAPHX_THROW("MIGRAPHX PYTHON: Expected " + std::to_string(output_shapes.size()) +
+                           " output buffers");
+        for(std::size_t i = 0; i < buffers.size(); i++)
+        {
+            infos.push_back(buffers[i].request(true));
+            auto s = to_shape(infos.back());
+            if(s.type() != output_shapes[i].type() or s.lens() != output_shapes[i].lens())
+                MIGRAPHX_THROW("MIGRAPHX PYTHON: Output buffer " + std::to_string(i) +
+                               " has shape " + migraphx::to_string(s) + ", expected " +
+                               migraphx::to_string(output_shapes[i]));
+            output_args.emplace_back(s, infos.back().ptr);
+            auto name = output_parameter_name(param_shapes, i);
+            if(not name.empty() and migraphx::contains(pm, name))
+                MIGRAPHX_THROW("MIGRAPHX PYTHON: Output buffer " + std::to_string(i) +
+                               " is also passed as parameter " + name);
+            // An async run returns before the outputs are ready, so they can only
+            // be written straight into the buffers
+            if(exec_env.async and name.empty())
+                MIGRAPHX_THROW("MIGRAPHX PYTHON: run_async can only write output buffer " +
+                               std::to_string(i) + " when the program takes it as a parameter");
+            // Let the program write straight into the buffer when it takes
+            // its outputs as parameters
+            if(name.empty())
+                continue;
+            if(param_shapes.at(name) != s)
+                MIGRAPHX_THROW("MIGRAPHX PYTHON: Output buffer " + std::to_string(i) +
+                               " must have shape " + migraphx::to_string(param_shapes.at(name)));
+            pm[name] = output_args.back();
+        }
+    }
+
+    auto scratch = exec_env.async ? std::vector<bool>{} : scratch_outputs(p);
+    auto& mutex  = program_mutex(self);
+    // Release the GIL before waiting on the program, since the thread running it
+    // needs the GIL to return
+    py::gil_scoped_release release;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto results = p.eval(pm, exec_env);
+    for(std::size_t i = 0; i < results.size(); i++)
+    {
+        if(i < output_args.size())
+        {
+            // Only targets that keep their outputs on the device take them as
+            // parameters, so an output the program allocated itself is on the host
+            if(results[i].data() != output_args[i].data())
+            {
+                visit_all(output_args[i], results[i])([](auto output, auto input) {
+                    std::copy(input.begin(), input.end(), output.begin());
+                });
+            }
+            results[i] = output_args[i];
+        }
+        else if(i < scratch.size() and scratch[i])
+        {
+            results[i] = results[i].copy();
+        }
+    }
+    return results;
+}
+
 MIGRAPHX_PYBIND11_MODULE(migraphx, m)
 {
     py::class_<migraphx::shape>(m, "shape")
@@ -321,7 +473,7 @@ MIGRAPHX_PYBIND11_MODULE(migraphx, m)
             py::arg("args"))
         .def("__repr__", [](const migraphx::module& mm) { return migraphx::to_string(mm); });
 
-    py::class_<migraphx::program>(m, "program")
+    py::class_<migraphx::program>(m, "program", py::dynamic_attr())
         .def(py::init([]() { return migraphx::program(); }))
         .def("get_parameter_names", &migraphx::program::get_parameter_names)
         .def("get_parameter_shapes", &migraphx::program::get_parameter_shapes)
@@ -343,35 +495,28 @@ MIGRAPHX_PYBIND11_MODULE(migraphx, m)
             "create_module",
             [](migraphx::program& p, const std::string& name) { return p.create_module(name); },
             py::arg("name"))
-        .def("run",
-             [](migraphx::program& p, py::dict params) {
-                 migraphx::parameter_map pm;
-                 for(auto x : params)
-                 {
-                     std::string key      = x.first.cast<std::string>();
-                     py::buffer b         = x.second.cast<py::buffer>();
-                     py::buffer_info info = b.request();
-                     pm[key]              = migraphx::argument(to_shape(info), info.ptr);
-                 }
-                 return p.eval(pm);
-             })
-        .def("run_async",
-             [](migraphx::program& p,
-                py::dict params,
-                std::uintptr_t stream,
-                std::string stream_name) {
-                 migraphx::parameter_map pm;
-                 for(auto x : params)
-                 {
-                     std::string key      = x.first.cast<std::string>();
-                     py::buffer b         = x.second.cast<py::buffer>();
-                     py::buffer_info info = b.request();
-                     pm[key]              = migraphx::argument(to_shape(info), info.ptr);
-                 }
-                 migraphx::execution_environment exec_env{
-                     migraphx::any_ptr(reinterpret_cast<void*>(stream), stream_name), true};
-                 return p.eval(pm, exec_env);
-             })
+        .def(
+            "run",
+            [](const py::object& self, py::dict params, py::object outputs) {
+                return run_program(self, params, outputs, migraphx::execution_environment{});
+            },
+            py::arg("params"),
+            py::arg("outputs") = py::none())
+        .def(
+            "run_async",
+            [](const py::object& self,
+               py::dict params,
+               std::uintptr_t stream,
+               std::string stream_name,
+               py::object outputs) {
+                migraphx::execution_environment exec_env{
+                    migraphx::any_ptr(reinterpret_cast<void*>(stream), stream_name), true};
+                return run_program(self, params, outputs, exec_env);
+            },
+            py::arg("params"),
+            py::arg("stream"),
+            py::arg("stream_name"),
+            py::arg("outputs") = py::none())
         .def("sort", &migraphx::program::sort)
         .def("print", [](const migraphx::program& p) { std::cout << p << std::endl; })
         .def("__eq__", std::equal_to<migraphx::program>{})
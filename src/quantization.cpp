@@ -39,7 +39,16 @@
 #include <migraphx/target.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/pass_manager.hpp>
+#include <migraphx/par_for.hpp>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <numeric>
 #include <set>
+#include <thread>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -63,10 +72,197 @@ void quantize_fp16(program& prog, const std::vector<std::string>& ins_names)
                 dead_code_elimination{}});
 }
 
+// Compute the max absolute value with a single pass over the data. Several independent
+// accumulators are used so the loop can be vectorized.
+template <class T>
+static float max_abs_value(const T* x, std::size_t n)
+{
+    const std::size_t lanes = 16;
+    std::array<float, lanes> m{};
+    std::size_t i = 0;
+    for(; i + lanes <= n; i += lanes)
+    {
+        for(std::size_t j = 0; j < lanes; j++)
+            m[j] = std::max(m[j], std::fabs(static_cast<float>(x[i + j])));
+    }
+    for(; i < n; i++)
+        m[0] = std::max(m[0], std::fabs(static_cast<float>(x[i])));
+    return *std::max_element(m.begin(), m.end());
+}
+
+// Visit the values of the argument. The order of the values does not matter, so the data of a
+// packed tensor is accessed directly even if it is transposed.
+template <class F>
+static void visit_values(const argument& arg, F f)
+{
+    arg.visit([&](auto t) {
+        if(t.get_shape().packed())
+        {
+            f(t.data(), t.get_shape().elements());
+        }
+        else
+        {
+            std::vector<typename decltype(t)::value_type> v(t.begin(), t.end());
+            f(v.data(), v.size());
+        }
+    });
+}
+
+// Find the range of the histogram covering the percentage of the values
+static float percentile_threshold(const std::vector<std::size_t>& hist, float max_abs, double pct)
+{
+    auto total = std::accumulate(hist.begin(), hist.end(), std::size_t{0});
+    if(total == 0)
+        return max_abs;
+    auto target     = pct / 100.0 * total;
+    std::size_t sum = 0;
+    for(std::size_t i = 0; i < hist.size(); i++)
+    {
+        sum += hist[i];
+        if(sum >= target)
+            return max_abs * (i + 1) / hist.size();
+    }
+    return max_abs;
+}
+
+// Find the range of the histogram where the KL divergence between the distribution and the
+// distribution quantized to int8 is the smallest
+static float entropy_threshold(const std::vector<std::size_t>& hist, float max_abs)
+{
+    const std::size_t levels = 128;
+    const std::size_t nbins  = hist.size();
+    auto total               = std::accumulate(hist.begin(), hist.end(), std::size_t{0});
+    if(total == 0 or nbins <= levels)
+        return max_abs;
+    std::vector<double> p(nbins);
+    std::vector<double> q(nbins);
+    double best_kl     = std::numeric_limits<double>::max();
+    std::size_t best_i = nbins;
+    // Number of values outside of the range
+    std::size_t outliers = total;
+    std::for_each(hist.begin(), hist.begin() + levels - 1, [&](auto x) { outliers -= x; });
+    for(std::size_t i = levels; i <= nbins; i++)
+    {
+        outliers -= hist[i - 1];
+        // Reference distribution with the outliers clipped into the last bin
+        std::copy(hist.begin(), hist.begin() + i, p.begin());
+        p[i - 1] += outliers;
+        // Merge the bins into the int8 levels and expand them back over the nonzero bins
+        for(std::size_t j = 0; j < levels; j++)
+        {
+            auto first        = j * i / levels;
+            auto last         = (j + 1) * i / levels;
+            double sum        = 0;
+            std::size_t count = 0;
+            for(auto k = first; k < last; k++)
+            {
+                sum += hist[k];
+                count += hist[k] != 0 ? 1 : 0;
+            }
+            for(auto k = first; k < last; k++)
+                q[k] = (hist[k] == 0 or count == 0) ? 0.0 : sum / count;
+        }
+        auto psum = std::accumulate(p.begin(), p.begin() + i, 0.0);
+        auto qsum = std::accumulate(q.begin(), q.begin() + i, 0.0);
+        if(qsum == 0.0)
+            continue;
+        double kl = 0.0;
+        for(std::size_t k = 0; k < i; k++)
+        {
+            if(p[k] == 0.0)
+                continue;
+            auto pk = p[k] / psum;
+            // Smooth the empty bins of the quantized distribution
+            auto qk = std::max(q[k] / qsum, 1e-12);
+            kl += pk * std::log(pk / qk);
+        }
+        if(kl < best_kl)
+        {
+            best_kl = kl;
+            best_i  = i;
+        }
+    }
+    return max_abs * std::min<float>(best_i + 0.5f, nbins) / nbins;
+}
+
+static bool is_host_target(const target& t) { return contains({"ref", "cpu"}, t.name()); }
+
+struct int8_calibrator
+{
+    int8_quantization_options options;
+    std::vector<float> max_abs_vals;
+    std::vector<std::vector<std::size_t>> histograms;
+    std::vector<bool> captured;
+    bool collect_histograms = false;
+    std::mutex m;
+
+    void resize(std::size_t n)
+    {
+        max_abs_vals.resize(n, 0.0f);
+        captured.resize(n, false);
+    }
+
+    void capture(std::size_t ins_index, const argument& arg)
+    {
+        if(not collect_histograms)
+        {
+            float max_abs = 0.0f;
+            visit_values(arg, [&](auto x, auto n) { max_abs = max_abs_value(x, n); });
+            std::lock_guard<std::mutex> lock(m);
+            max_abs_vals.at(ins_index) = std::max(max_abs_vals.at(ins_index), max_abs);
+            captured.at(ins_index)     = true;
+            return;
+        }
+        auto range = max_abs_vals.at(ins_index);
+        if(range == 0.0f)
+            return;
+        std::vector<std::size_t> hist(options.bins);
+        const float bin_scale = options.bins / range;
+        visit_values(arg, [&](auto x, auto n) {
+            for(std::size_t i = 0; i < n; i++)
+            {
+                auto bin =
+                    static_cast<std::size_t>(std::fabs(static_cast<float>(x[i])) * bin_scale);
+                hist[std::min(bin, options.bins - 1)]++;
+            }
+        });
+        std::lock_guard<std::mutex> lock(m);
+        auto& result = histograms.at(ins_index);
+        std::transform(result.begin(), result.end(), hist.begin(), result.begin(), std::plus<>{});
+    }
+
+    std::pair<float, float> quant_param(std::size_t ins_index) const
+    {
+        // scale and shift is need for only int8 type, and we do not
+        // consider shift, so set shift to 0
+        if(not captured.at(ins_index))
+            return {64.0f, 0.0f};
+        float threshold = max_abs_vals.at(ins_index);
+        if(options.method == int8_calibration::percentile)
+            threshold =
+                percentile_threshold(histograms.at(ins_index), threshold, options.percentile);
+        else if(options.method == int8_calibration::entropy)
+            threshold = entropy_threshold(histograms.at(ins_index), threshold);
+        // if all values are 0, no need to do scaling
+        if(threshold == 0.0f)
+            return {1.0f, 0.0f};
+        return {127.0f / threshold, 0.0f};
+    }
+};
+
 void quantize_int8(program& prog,
                    const target& t,
                    const std::vector<parameter_map>& calibration,
                    const std::vector<std::string>& ins_names)
+{
+    quantize_int8(prog, t, calibration, ins_names, int8_quantization_options{});
+}
+
+void quantize_int8(program& prog,
+                   const target& t,
+                   const std::vector<parameter_map>& calibration,
+                   const std::vector<std::string>& ins_names,
+                   const int8_quantization_options& options)
 {
     std::set<std::string> op_names = {"convolution", "dot"};
     std::set<std::string> input_ins_names(ins_names.begin(), ins_names.end());
@@ -75,56 +271,61 @@ void quantize_int8(program& prog,
     {
         MIGRAPHX_THROW("QUANTIZE_INT8: only support DOT and CONVOLUTION operation");
     }
+    if(options.method != int8_calibration::max_abs and options.bins < 128)
+    {
+        MIGRAPHX_THROW("QUANTIZE_INT8: histogram calibration needs at least 128 bins");
+    }
 
-    std::shared_ptr<std::vector<std::pair<float, float>>> int8_quant_params =
-        std::make_shared<std::vector<std::pair<float, float>>>();
-    std::shared_ptr<std::vector<float>> max_abs_vals = std::make_shared<std::vector<float>>();
-
-    auto calc_quant_params = [int8_quant_params, max_abs_vals, &t](std::size_t ins_index,
-                                                                   std::vector<argument> args) {
-        std::pair<float, float> param_pair{64.0f, 0.0f};
-        // scale and shift is need for only int8 type, and we do not
-        // consider shift, so set shift to 0
-        std::vector<float> vec_val;
-        argument arg = t.copy_from(args.front());
-        arg.visit([&](auto output) { vec_val.assign(output.begin(), output.end()); });
-        auto max_val                = *std::max_element(vec_val.begin(), vec_val.end());
-        auto min_val                = *std::min_element(vec_val.begin(), vec_val.end());
-        auto max_abs                = std::max(std::fabs(max_val), std::fabs(min_val));
-        max_abs_vals->at(ins_index) = std::max(max_abs_vals->at(ins_index), max_abs);
+    auto calibrator     = std::make_shared<int8_calibrator>();
+    calibrator->options = options;
 
-        // if all values are 0, no need to do scaling
-        if(max_abs_vals->at(ins_index) == 0.0f)
-        {
-            param_pair.first = 1.0f;
-        }
-        else
-        {
-            param_pair.first = 127.0f / max_abs_vals->at(ins_index);
-        }
-        int8_quant_params->at(ins_index) = param_pair;
+    auto calc_quant_params = [calibrator, &t](std::size_t ins_index, std::vector<argument> args) {
+        calibrator->capture(ins_index, t.copy_from(args.front()));
     };
 
     // pass to add capture argument op
     std::size_t param_num = 0;
     run_passes(prog, {capture_arguments_pass{ins_names, calc_quant_params, &param_num}});
-    int8_quant_params->resize(param_num, std::pair<float, float>(64.0f, 0.0f));
-    max_abs_vals->resize(param_num, 0.0f);
+    calibrator->resize(param_num);
 
-    // use the calibration data to compute the quantization scale
-    auto capture_prog = prog;
-    capture_prog.compile(t);
+    const std::size_t cores = std::max<std::size_t>(1, std::thread::hardware_concurrency());
 
-    // use all calibration data to run the program to calculate the
-    // quantization scale and shift
-    for(auto&& arg : calibration)
-    {
+    // Each thread compiles its own copy of the program, so only a few are used by default
+    const std::size_t default_threads = 4;
+    std::size_t num_threads           = options.num_threads;
+    if(not is_host_target(t))
+        num_threads = 1;
+    else if(num_threads == 0)
+        num_threads = std::min(cores, default_threads);
+    num_threads = std::max<std::size_t>(1, std::min(num_threads, calibration.size()));
+    // The operators of each copy only use its share of the cores
+    const std::size_t threads_per_copy = std::max<std::size_t>(1, cores / num_threads);
+
+    // use the calibration data to compute the quantization scale, each thread evaluates its own
+    // copy of the program
+    std::vector<program> capture_progs(num_threads, prog);
+    for(auto& capture_prog : capture_progs)
+        capture_prog.compile(t);
+
+    auto eval_calibration = [&](const parameter_map& arg, program& capture_prog) {
+        if(num_threads > 1)
+        {
+            auto& ctx = capture_prog.get_context();
+            auto v    = ctx.to_value();
+            if(v.contains("threads"))
+            {
+                v["threads"] = threads_per_copy;
+                ctx.from_value(v);
+            }
+        }
         parameter_map m;
         for(auto&& x : capture_prog.get_parameter_shapes())
         {
             if(arg.count(x.first) > 0)
             {
-                assert(x.second == arg.at(x.first).get_shape());
+                if(x.second != arg.at(x.first).get_shape())
+                    MIGRAPHX_THROW("QUANTIZE_INT8: Calibration data for " + x.first +
+                                   " has the wrong shape");
                 m[x.first] = t.copy_to(arg.at(x.first));
             }
             else
@@ -133,14 +334,53 @@ void quantize_int8(program& prog,
             }
         }
         capture_prog.eval(m);
+    };
+
+    auto run_calibration = [&] {
+        std::vector<std::exception_ptr> errors(calibration.size());
+        std::atomic<bool> failed{false};
+        par_for_impl(calibration.size(), num_threads, [&](auto i, auto tid) {
+            if(failed)
+                return;
+            try
+            {
+                eval_calibration(calibration[i], capture_progs[tid]);
+            }
+            catch(...)
+            {
+                errors[i] = std::current_exception();
+                failed    = true;
+            }
+        });
+        // Rethrow on the calling thread, since an exception escaping a worker terminates
+        for(const auto& e : errors)
+        {
+            if(e)
+                std::rethrow_exception(e);
+        }
+    };
+
+    // use all calibration data to run the program to calculate the
+    // quantization scale and shift
+    run_calibration();
+    if(options.method != int8_calibration::max_abs)
+    {
+        // The histograms use the ranges from the first pass
+        calibrator->histograms.resize(param_num, std::vector<std::size_t>(options.bins));
+        calibrator->collect_histograms = true;
+        run_calibration();
     }
 
+    std::vector<std::pair<float, float>> int8_quant_params(param_num);
+    for(std::size_t i = 0; i < param_num; ++i)
+        int8_quant_params[i] = calibrator->quant_param(i);
+
     // print the quantization parameters in only the main module
     if(enabled(MIGRAPHX_INT8_QUANTIZATION_PARAMS{}))
     {
-        for(std::size_t i = 0; i < int8_quant_params->size(); ++i)
+        for(std::size_t i = 0; i < int8_quant_params.size(); ++i)
         {
-            auto param = int8_quant_params->at(i);
+            auto param = int8_quant_params.at(i);
             std::cout << "ins_index = " << i << ", scale = " << param.first
                       << ", shift = " << param.second << std::endl;
         }
@@ -148,7 +388,7 @@ void quantize_int8(program& prog,
     }
 
     run_passes(prog,
-               {quantize_int8_pass{ins_names, *int8_quant_params},
+               {quantize_int8_pass{ins_names, int8_quant_params, options.per_channel},
                 eliminate_common_subexpression{},
                 dead_code_elimination{},
                 simplify_reshapes{},
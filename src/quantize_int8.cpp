@@ -35,6 +35,9 @@
 #include <migraphx/target.hpp>
 #include <migraphx/make_op.hpp>
 #include <migraphx/pass_manager.hpp>
+#include <migraphx/optional.hpp>
+#include <migraphx/shape_for_each.hpp>
+#include <cmath>
 #include <numeric>
 #include <set>
 
@@ -50,6 +53,41 @@ static std::vector<shape::type_t>& get_quantizable_type()
     return quantable_types;
 }
 
+// The weights of convolution and dot that are constant can be quantized with one scale per output
+// channel, which is the axis returned here
+static optional<std::size_t> weight_channel_axis(instruction_ref ins)
+{
+    if(ins->outputs().size() != 1)
+        return nullopt;
+    auto qop   = ins->outputs().front();
+    auto input = ins->inputs().front();
+    if(qop->inputs().size() < 2 or qop->inputs().at(1) != ins or input->get_shape().dynamic() or
+       not input->can_eval())
+        return nullopt;
+    if(qop->name() == "convolution")
+        return 0;
+    if(qop->name() == "dot")
+        return input->get_shape().lens().size() - 1;
+    return nullopt;
+}
+
+static std::vector<float> per_channel_scales(instruction_ref input, std::size_t axis)
+{
+    auto arg = input->eval();
+    std::vector<double> max_abs(arg.get_shape().lens().at(axis), 0.0);
+    arg.visit([&](auto t) {
+        shape_for_each(t.get_shape(), [&](const auto& idx) {
+            auto& m = max_abs[idx[axis]];
+            m       = std::max<double>(m, std::fabs(double(t(idx.begin(), idx.end()))));
+        });
+    });
+    std::vector<float> scales(max_abs.size());
+    std::transform(max_abs.begin(), max_abs.end(), scales.begin(), [](auto x) {
+        return x == 0.0 ? 1.0f : static_cast<float>(x / 127.0);
+    });
+    return scales;
+}
+
 void quantize_int8_pass::apply(module& m) const // NOLINT
 {
     const auto& quantizable_types = get_quantizable_type();
@@ -69,10 +107,22 @@ void quantize_int8_pass::apply(module& m) const // NOLINT
         if(contains(quantizable_types, s.type()) and s.type() != shape::int8_type)
         {
             auto zero_point  = m.add_literal(static_cast<int8_t>(param.second));
-            auto scale       = m.add_literal(literal({s.type()}, {1.0f / param.first}));
             const auto& lens = s.lens();
-            scale =
-                m.insert_instruction(ins, make_op("multibroadcast", {{"out_lens", lens}}), scale);
+            instruction_ref scale;
+            auto axis = per_channel ? weight_channel_axis(ins) : nullopt;
+            if(axis)
+            {
+                auto scales = per_channel_scales(input, *axis);
+                scale       = m.add_literal(literal({s.type(), {scales.size()}}, scales));
+                scale       = m.insert_instruction(
+                    ins, make_op("broadcast", {{"axis", *axis}, {"out_lens", lens}}), scale);
+            }
+            else
+            {
+                scale = m.add_literal(literal({s.type()}, {1.0f / param.first}));
+                scale = m.insert_instruction(
+                    ins, make_op("multibroadcast", {{"out_lens", lens}}), scale);
+            }
             zero_point = m.insert_instruction(
                 ins, make_op("multibroadcast", {{"out_lens", lens}}), zero_point);
             auto q_in =
@@ -29,6 +29,18 @@
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+value::binary raw_data_bytes(const argument& a)
+{
+    return value::binary(a.data(), a.get_shape().bytes());
+}
+
+// A literal never changes, so the value refers to its data instead of copying it
+value::binary_view raw_data_bytes(const literal& l)
+{
+    auto owner = std::make_shared<literal>(l);
+    return {owner->data(), owner->get_shape().bytes(), owner};
+}
+
 template <class RawData>
 void raw_data_to_value(value& v, const RawData& rd)
 {
@@ -37,7 +49,7 @@ void raw_data_to_value(value& v, const RawData& rd)
     if(rd.get_shape().type() == shape::tuple_type)
         result["sub"] = migraphx::to_value(rd.get_sub_objects());
     else if(not rd.empty())
-        result["data"] = migraphx::value::binary(rd.data(), rd.get_shape().bytes());
+        result["data"] = raw_data_bytes(rd);
     v = result;
 }
 
@@ -45,7 +57,7 @@ void migraphx_to_value(value& v, const literal& l) { raw_data_to_value(v, l); }
 void migraphx_from_value(const value& v, literal& l)
 {
     auto s = migraphx::from_value<shape>(v.at("shape"));
-    l      = literal(s, v.at("data").get_binary().data());
+    l      = literal(s, v.at("data").get_binary_view().data);
 }
 
 void migraphx_to_value(value& v, const argument& a) { raw_data_to_value(v, a); }
@@ -304,16 +304,13 @@ std::size_t shape::index(std::size_t i) const
         return i;
     else
     {
-        std::size_t s      = 1;
-        std::size_t result = 0;
-        for(std::size_t j = 0; j < this->lens().size(); j++)
+        const auto& lens    = this->lens();
+        const auto& strides = this->strides();
+        std::size_t result  = 0;
+        for(std::size_t k = lens.size(); k > 0; k--)
         {
-            const std::size_t k      = this->lens().size() - j - 1;
-            const std::size_t stride = this->strides()[k];
-            const std::size_t len    = this->lens()[k];
-            const std::size_t idx    = (i % (s * len)) / s;
-            result += stride * idx;
-            s *= len;
+            result += strides[k - 1] * (i % lens[k - 1]);
+            i /= lens[k - 1];
         }
         return result;
     }
@@ -334,14 +331,13 @@ void shape::multi_copy(std::size_t i, std::size_t* start, const std::size_t* end
     assert(this->standard());
     (void)end;
     assert(lens().size() <= (end - start));
-    std::transform(strides().begin(),
-                   strides().end(),
-                   lens().begin(),
-                   start,
-                   [&](std::size_t stride, std::size_t len) {
-                       assert(len > 0 and stride > 0);
-                       return (i / stride) % len;
-                   });
+    for(std::size_t k = lens().size(); k > 0; k--)
+    {
+        const std::size_t len = lens()[k - 1];
+        assert(len > 0);
+        start[k - 1] = i % len;
+        i /= len;
+    }
 }
 
 bool shape::packed() const
@@ -559,7 +559,7 @@ struct find_splits
         {
             auto slc         = any_cast<op::slice>(split_front->get_operator());
             auto slc_axes    = slc.axes;
-            auto reduce_axes = start->get_operator().to_value()["axes"].to_vector<int64_t>();
+            auto reduce_axes = start->get_operator().field("axes").to_vector<int64_t>();
             // axes of slice and reduce op cannot have overlap
             if(std::any_of(slc_axes.begin(), slc_axes.end(), [&](auto axis) {
                    return (std::find(reduce_axes.begin(), reduce_axes.end(), axis) !=
@@ -45,7 +45,7 @@ std::unordered_set<std::string> get_quantizable_op_names()
     return s;
 }
 
-MIGRAPHX_PRED_MATCHER(has_same_value, instruction_ref ins)
+static bool is_same_value(instruction_ref ins)
 {
     if(ins->name() != "@literal")
         return false;
@@ -58,22 +58,50 @@ MIGRAPHX_PRED_MATCHER(has_same_value, instruction_ref ins)
     return all_same;
 }
 
+MIGRAPHX_PRED_MATCHER(has_same_value, instruction_ref ins) { return is_same_value(ins); }
+
 struct match_find_quantizable_ops
 {
 
-    static auto dequantizelinear_op(const std::string& name, const std::string& scale)
+    template <class M>
+    static auto
+    dequantizelinear_op(const std::string& name, const std::string& scale, M scale_matcher)
     {
         return match::name("dequantizelinear")(
             match::arg(0)(match::skip(match::name("quantizelinear"))(match::any().bind(name))),
-            match::arg(1)(match::skip_broadcasts(has_same_value().bind(scale))),
+            match::arg(1)(match::skip_broadcasts(scale_matcher.bind(scale))),
             match::arg(2)(match::skip_broadcasts(match::all_of(match::has_value(0)))));
     }
 
     auto matcher() const
     {
+        // The weights can also use one scale per output channel
         return match::name(get_quantizable_op_names())(
-            match::arg(0)(dequantizelinear_op("x1", "scale1")),
-            match::arg(1)(dequantizelinear_op("x2", "scale2")));
+            match::arg(0)(dequantizelinear_op("x1", "scale1", has_same_value())),
+            match::arg(1)(dequantizelinear_op("x2", "scale2", match::name("@literal"))));
+    }
+
+    // The axis of the output channels in the weights and in the output of the operator
+    static std::pair<std::size_t, std::size_t> channel_axes(instruction_ref qop)
+    {
+        if(qop->name() == "convolution")
+            return {0, 1};
+        auto axis = qop->get_shape().lens().size() - 1;
+        return {axis, axis};
+    }
+
+    // Check the scale is a vector broadcasted along the output channels of the weights
+    static bool is_per_channel_scale(instruction_ref qop, instruction_ref scale)
+    {
+        auto bcast = qop->inputs().at(1)->inputs().at(1);
+        if(bcast->name() != "broadcast" or bcast->inputs().front() != scale)
+            return false;
+        auto axis = channel_axes(qop).first;
+        if(bcast->get_operator().field("axis").to<std::size_t>() != axis)
+            return false;
+        const auto& s = scale->get_shape();
+        return s.lens().size() == 1 and
+               s.elements() == qop->inputs().at(1)->get_shape().lens().at(axis);
     }
 
     void apply(module& m, const match::matcher_result& r) const
@@ -89,9 +117,18 @@ struct match_find_quantizable_ops
            q2->get_shape().type() != migraphx::shape::int8_type)
             return;
 
-        double scale;
-        visit_all(scale1->get_literal(), scale2->get_literal())(
-            [&](const auto s1, const auto s2) { scale = s1.front() * s2.front(); });
+        bool per_channel = not is_same_value(scale2);
+        if(per_channel and not is_per_channel_scale(qop, scale2))
+            return;
+
+        std::vector<double> scales;
+        visit_all(scale1->get_literal(), scale2->get_literal())([&](const auto s1, const auto s2) {
+            std::transform(s2.begin(), s2.end(), std::back_inserter(scales), [&](auto x) {
+                return double(s1.front()) * x;
+            });
+        });
+        if(not per_channel)
+            scales.resize(1);
 
         auto qop_args  = qop->inputs();
         qop_args.at(0) = q1;
@@ -110,11 +147,23 @@ struct match_find_quantizable_ops
             dq = m.insert_instruction(qop, migraphx::make_op("quant_dot"), qop_args);
         }
         auto ins_type = qop->get_shape().type();
-        dq_scale      = m.add_literal(literal({ins_type}, {scale}));
-
-        auto lens = dq->get_shape().lens();
-        auto scale_mb =
-            m.insert_instruction(qop, make_op("multibroadcast", {{"out_lens", lens}}), dq_scale);
+        auto lens     = dq->get_shape().lens();
+        instruction_ref scale_mb;
+        if(per_channel)
+        {
+            // Fold the weight scales into the scale of the output channels
+            dq_scale = m.add_literal(literal({ins_type, {scales.size()}}, scales));
+            scale_mb = m.insert_instruction(
+                qop,
+                make_op("broadcast", {{"axis", channel_axes(qop).second}, {"out_lens", lens}}),
+                dq_scale);
+        }
+        else
+        {
+            dq_scale = m.add_literal(literal({ins_type}, scales));
+            scale_mb = m.insert_instruction(
+                qop, make_op("multibroadcast", {{"out_lens", lens}}), dq_scale);
+        }
         dq = m.insert_instruction(qop, make_op("dequantizelinear"), dq, scale_mb);
         m.replace_instruction(qop, dq);
     }
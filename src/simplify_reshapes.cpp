@@ -655,7 +655,7 @@ struct find_slice_transpose
         std::map<std::vector<int64_t>, int64_t> count;
         for(auto t : transposes)
         {
-            auto perm = t->get_operator().to_value()["permutation"].to_vector<int64_t>();
+            auto perm = t->get_operator().field("permutation").to_vector<int64_t>();
             count[perm]++;
         }
         return std::max_element(
@@ -696,7 +696,7 @@ struct find_slice_transpose
             auto new_ins = m.insert_instruction(t, op, pre);
             if(t->get_operator() != pre->get_operator())
             {
-                auto curr = t->get_operator().to_value()["permutation"].to_vector<int64_t>();
+                auto curr = t->get_operator().field("permutation").to_vector<int64_t>();
                 new_ins   = m.insert_instruction(
                     t, make_op("transpose", {{"permutation", reorder_dims(iperm, curr)}}), new_ins);
             }
@@ -761,7 +761,7 @@ struct find_transpose_slice
                        [](auto x) { return x == 1; }))
             return;
         // Compute axis before transpose to use for unsqueeze
-        auto perm    = ins->get_operator().to_value()["permutation"].to_vector<int64_t>();
+        auto perm    = ins->get_operator().field("permutation").to_vector<int64_t>();
         auto preaxis = std::find(perm.begin(), perm.end(), axis) - perm.begin();
         // Make unsqeeze
         auto unsqueeze = m.insert_instruction(
@@ -0,0 +1,258 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/specialization_cache.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/stringutils.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/env.hpp>
+#include <algorithm>
+#include <iostream>
+#include <list>
+#include <map>
+#include <mutex>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_TRACE_SPECIALIZATION)
+
+static bool fits(const shape& dyn, const shape& s)
+{
+    if(s.dynamic() or s.type() != dyn.type())
+        return false;
+    const auto& dds = dyn.dyn_dims();
+    if(dds.size() != s.lens().size())
+        return false;
+    return std::equal(dds.begin(), dds.end(), s.lens().begin(), [](const auto& dd, auto len) {
+        return len >= dd.min and len <= dd.max;
+    });
+}
+
+program specialize_program(const program& p,
+                           const std::unordered_map<std::string, shape>& param_shapes)
+{
+    program result = p;
+    auto* mm       = result.get_main_module();
+    for(auto ins : iterator_for(*mm))
+    {
+        if(ins->name() != "@param" or not ins->get_shape().dynamic())
+            continue;
+        auto name = any_cast<builtin::param>(ins->get_operator()).parameter;
+        auto it   = param_shapes.find(name);
+        if(it == param_shapes.end())
+            MIGRAPHX_THROW("SPECIALIZE_PROGRAM: Missing shape for dynamic parameter: " + name);
+        if(not fits(ins->get_shape(), it->second))
+            MIGRAPHX_THROW("SPECIALIZE_PROGRAM: Shape {" + to_string(it->second) +
+                           "} is not within the dynamic shape {" + to_string(ins->get_shape()) +
+                           "} of parameter: " + name);
+        instruction::replace(ins, ins->get_operator(), it->second, ins->inputs());
+    }
+    return result;
+}
+
+using specialization_key = std::vector<std::vector<std::size_t>>;
+
+// A compiled program uses the same scratch memory and context on every eval, so the evals of a
+// specialization are serialized
+struct specialization
+{
+    program prog;
+    std::mutex m;
+};
+
+struct specialization_cache_impl
+{
+    using entry = std::pair<specialization_key, std::shared_ptr<specialization>>;
+
+    program prog;
+    target t;
+    compile_options options;
+    std::size_t capacity = 0;
+    std::size_t hits     = 0;
+    std::size_t misses   = 0;
+    // Ordered names of the dynamic parameters
+    std::vector<std::string> dyn_params;
+    // Most recently used specialization is at the front
+    std::list<entry> lru;
+    std::map<specialization_key, std::list<entry>::iterator> lookup;
+    std::mutex m;
+
+    specialization_key
+    make_key(const std::unordered_map<std::string, shape>& param_shapes) const
+    {
+        specialization_key key;
+        key.reserve(dyn_params.size());
+        std::transform(dyn_params.begin(),
+                       dyn_params.end(),
+                       std::back_inserter(key),
+                       [&](const auto& name) {
+                           auto it = param_shapes.find(name);
+                           if(it == param_shapes.end())
+                               MIGRAPHX_THROW("SPECIALIZATION_CACHE: Missing dynamic parameter: " +
+                                              name);
+                           return it->second.lens();
+                       });
+        return key;
+    }
+
+    std::shared_ptr<specialization>
+    compile(const std::unordered_map<std::string, shape>& param_shapes)
+    {
+        if(enabled(MIGRAPHX_TRACE_SPECIALIZATION{}))
+        {
+            std::cout << "Compile specialization:";
+            for(const auto& name : dyn_params)
+                std::cout << " " << name << "=" << param_shapes.at(name);
+            std::cout << std::endl;
+        }
+        auto sp  = std::make_shared<specialization>();
+        sp->prog = specialize_program(prog, param_shapes);
+        sp->prog.compile(t, options);
+        return sp;
+    }
+
+    std::shared_ptr<specialization>
+    get(const std::unordered_map<std::string, shape>& param_shapes)
+    {
+        auto key = make_key(param_shapes);
+        std::unique_lock<std::mutex> lock(m);
+        auto it = lookup.find(key);
+        if(it != lookup.end())
+        {
+            hits++;
+            lru.splice(lru.begin(), lru, it->second);
+            return it->second->second;
+        }
+        misses++;
+        // Compilation can be slow so dont hold the lock while compiling
+        lock.unlock();
+        auto sp = compile(param_shapes);
+        lock.lock();
+        // Another thread could have compiled the same specialization
+        it = lookup.find(key);
+        if(it != lookup.end())
+        {
+            lru.splice(lru.begin(), lru, it->second);
+            return it->second->second;
+        }
+        lru.emplace_front(key, sp);
+        lookup[key] = lru.begin();
+        while(lru.size() > capacity)
+        {
+            lookup.erase(lru.back().first);
+            lru.pop_back();
+        }
+        return sp;
+    }
+};
+
+specialization_cache::specialization_cache(program p,
+                                           target t,
+                                           compile_options options,
+                                           std::size_t capacity)
+    : impl(std::make_unique<specialization_cache_impl>())
+{
+    if(p.is_compiled())
+        MIGRAPHX_THROW("SPECIALIZATION_CACHE: Program is already compiled");
+    if(capacity == 0)
+        MIGRAPHX_THROW("SPECIALIZATION_CACHE: Capacity must be greater than zero");
+    impl->prog     = std::move(p);
+    impl->t        = std::move(t);
+    impl->options  = std::move(options);
+    impl->capacity = capacity;
+    for(auto&& [name, s] : impl->prog.get_parameter_shapes())
+    {
+        if(s.dynamic())
+            impl->dyn_params.push_back(name);
+    }
+    std::sort(impl->dyn_params.begin(), impl->dyn_params.end());
+}
+
+specialization_cache::specialization_cache(specialization_cache&&) noexcept            = default;
+specialization_cache& specialization_cache::operator=(specialization_cache&&) noexcept = default;
+specialization_cache::~specialization_cache() noexcept                                 = default;
+
+void specialization_cache::warmup()
+{
+    std::unordered_map<std::string, shape> param_shapes;
+    for(const auto& name : impl->dyn_params)
+    {
+        auto s = impl->prog.get_parameter_shape(name);
+        std::vector<std::size_t> lens;
+        for(const auto& dd : s.dyn_dims())
+        {
+            if(dd.is_fixed())
+                lens.push_back(dd.min);
+            else if(dd.has_optimal())
+                lens.push_back(dd.opt);
+            else
+                return;
+        }
+        param_shapes[name] = shape{s.type(), lens};
+    }
+    impl->get(param_shapes);
+}
+
+std::shared_ptr<program>
+specialization_cache::get(const std::unordered_map<std::string, shape>& param_shapes)
+{
+    auto sp = impl->get(param_shapes);
+    return {sp, &sp->prog};
+}
+
+std::vector<argument> specialization_cache::eval(parameter_map params)
+{
+    std::unordered_map<std::string, shape> param_shapes;
+    for(const auto& name : impl->dyn_params)
+    {
+        if(not contains(params, name))
+            MIGRAPHX_THROW("SPECIALIZATION_CACHE: Parameter not found: " + name);
+        const auto& s      = params.at(name).get_shape();
+        param_shapes[name] = shape{s.type(), s.lens()};
+    }
+    auto sp = impl->get(param_shapes);
+    std::lock_guard<std::mutex> lock(sp->m);
+    return sp->prog.eval(std::move(params));
+}
+
+std::size_t specialization_cache::size() const
+{
+    std::lock_guard<std::mutex> lock(impl->m);
+    return impl->lru.size();
+}
+std::size_t specialization_cache::capacity() const { return impl->capacity; }
+std::size_t specialization_cache::hits() const
+{
+    std::lock_guard<std::mutex> lock(impl->m);
+    return impl->hits;
+}
+std::size_t specialization_cache::misses() const
+{
+    std::lock_guard<std::mutex> lock(impl->m);
+    return impl->misses;
+}
+
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
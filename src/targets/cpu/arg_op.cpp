@@ -0,0 +1,230 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/config.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/op/argmax.hpp>
+#include <migraphx/op/argmin.hpp>
+#include <algorithm>
+#include <array>
+#include <type_traits>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+template <class Op>
+struct cpu_arg_op : auto_register_op<cpu_arg_op<Op>>
+{
+    Op op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+    std::string name() const { return "cpu::" + op.name(); }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        // Compensate for allocation
+        inputs.pop_back();
+        return migraphx::compute_shape(op, inputs);
+    }
+
+    // Strict comparison so that the first occurrence wins, as in the reference op
+    template <class T>
+    static bool better(T x, T y)
+    {
+        if constexpr(std::is_same<Op, op::argmax>{})
+            return y < x;
+        else
+            return x < y;
+    }
+
+    // Index of the best element of a contiguous row. The best value is found with independent
+    // lanes so the loop vectorizes, then the first element equal to it is located. A NaN
+    // defeats the equality search, so that case falls back to the sequential scan.
+    template <class T>
+    static std::size_t arg_row(const T* x, std::size_t n)
+    {
+        constexpr std::size_t lanes = 8;
+        std::array<T, lanes> acc;
+        acc.fill(x[0]);
+        std::size_t i = 0;
+        for(; i + lanes <= n; i += lanes)
+        {
+            for(std::size_t l = 0; l < lanes; l++)
+                acc[l] = better(x[i + l], acc[l]) ? x[i + l] : acc[l];
+        }
+        for(; i < n; i++)
+            acc[0] = better(x[i], acc[0]) ? x[i] : acc[0];
+        T best = acc[0];
+        for(std::size_t l = 1; l < lanes; l++)
+            best = better(acc[l], best) ? acc[l] : best;
+        const auto* it = std::find(x, x + n, best);
+        if(it != x + n)
+            return it - x;
+        std::size_t r = 0;
+        for(i = 1; i < n; i++)
+        {
+            if(better(x[i], x[r]))
+                r = i;
+        }
+        return r;
+    }
+
+    argument
+    compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
+    {
+        auto in_s       = args[0].get_shape();
+        auto axis       = op.axis;
+        std::size_t n   = in_s.lens()[axis];
+        std::size_t out = output_shape.elements();
+        auto* output    = args.back().cast<int64_t>();
+        args[0].visit([&](auto input) {
+            using type    = typename decltype(input)::value_type;
+            const type* x = input.data();
+            if(in_s.standard() and in_s.strides()[axis] == 1)
+            {
+                compute_rows(ctx, x, n, out, output);
+            }
+            else if(in_s.standard())
+            {
+                std::size_t inner = in_s.strides()[axis];
+                compute_columns(ctx, x, n, out / inner, inner, output);
+            }
+            else
+            {
+                // Any other layout: scan each row with the stride of the axis
+                std::size_t stride = in_s.strides()[axis];
+                std::size_t grain  = std::max<std::size_t>(1, 4096 / n);
+                ctx.bulk_execute(out, grain, [&](auto start, auto end) {
+                    for(auto i = start; i < end; i++)
+                    {
+                        const type* row = x + in_s.index(output_shape.multi(i));
+                        std::size_t r   = 0;
+                        for(std::size_t j = 1; j < n; j++)
+                        {
+                            if(better(row[j * stride], row[r * stride]))
+                                r = j;
+                        }
+                        output[i] = r;
+                    }
+                });
+            }
+        });
+        return args.back();
+    }
+
+    // The reduced axis is innermost
+    template <class T>
+    static void
+    compute_rows(context& ctx, const T* x, std::size_t n, std::size_t rows, int64_t* output)
+    {
+        std::size_t chunk   = 16384;
+        std::size_t nchunks = std::min(max_threads(), (n + chunk - 1) / chunk);
+        if(rows >= max_threads() or nchunks <= 1)
+        {
+            ctx.bulk_execute(rows, std::max<std::size_t>(1, 4096 / n), [&](auto start, auto end) {
+                for(auto r = start; r < end; r++)
+                    output[r] = arg_row(x + r * n, n);
+            });
+            return;
+        }
+        // Too few rows to keep every thread busy: split each row into chunks, reduce the chunks
+        // in parallel and merge them in order so that ties still resolve to the first index
+        chunk = (n + nchunks - 1) / nchunks;
+        std::vector<std::size_t> best(nchunks);
+        for(std::size_t r = 0; r < rows; r++)
+        {
+            const T* row = x + r * n;
+            ctx.bulk_execute(nchunks, 1, [&](auto start, auto end) {
+                for(auto c = start; c < end; c++)
+                {
+                    std::size_t first = c * chunk;
+                    std::size_t len   = std::min(chunk, n - first);
+                    best[c]           = first + arg_row(row + first, len);
+                }
+            });
+            std::size_t result = best[0];
+            for(std::size_t c = 1; c < nchunks; c++)
+            {
+                if(better(row[best[c]], row[result]))
+                    result = best[c];
+            }
+            output[r] = result;
+        }
+    }
+
+    // The reduced axis has contiguous elements after it: keep a running best for a block of
+    // that inner dimension so the comparisons run across consecutive elements
+    template <class T>
+    static void compute_columns(context& ctx,
+                                const T* x,
+                                std::size_t n,
+                                std::size_t outer,
+                                std::size_t inner,
+                                int64_t* output)
+    {
+        constexpr std::size_t block = 256;
+        std::size_t nblocks         = (inner + block - 1) / block;
+        ctx.bulk_execute(outer * nblocks, 1, [&](auto start, auto end) {
+            std::array<T, block> best_val;
+            std::array<int64_t, block> best_idx;
+            for(auto t = start; t < end; t++)
+            {
+                std::size_t o     = t / nblocks;
+                std::size_t first = (t % nblocks) * block;
+                std::size_t len   = std::min(block, inner - first);
+                const T* base     = x + o * n * inner + first;
+                std::copy(base, base + len, best_val.begin());
+                std::fill(best_idx.begin(), best_idx.begin() + len, 0);
+                for(std::size_t j = 1; j < n; j++)
+                {
+                    const T* row = base + j * inner;
+                    for(std::size_t i = 0; i < len; i++)
+                    {
+                        bool b      = better(row[i], best_val[i]);
+                        best_val[i] = b ? row[i] : best_val[i];
+                        best_idx[i] = b ? j : best_idx[i];
+                    }
+                }
+                std::copy(best_idx.begin(), best_idx.begin() + len, output + o * inner + first);
+            }
+        });
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+template struct cpu_arg_op<op::argmax>;
+template struct cpu_arg_op<op::argmin>;
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -39,27 +39,25 @@ MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_DNNL_POST_OPS_WORKAROUND);
 
 MIGRAPHX_PRED_MATCHER(has_post_ops, instruction_ref ins)
 {
-    auto v = ins->get_operator().to_value();
-    return v.contains("post_ops");
+    return not ins->get_operator().field("post_ops").is_null();
 }
 
 MIGRAPHX_PRED_MATCHER(without_post_ops, instruction_ref ins)
 {
-    auto v = ins->get_operator().to_value();
-    return v.contains("post_ops") and v["post_ops"].empty();
+    auto post_ops = ins->get_operator().field("post_ops");
+    return not post_ops.is_null() and post_ops.empty();
 }
 
 bool workaround_dnnl_broken_post_ops(const operation& op, const operation& post_op)
 {
     if(contains({"dnnl::dot", "dnnl::convolution"}, op.name()))
         return true;
-    auto pv = post_op.to_value();
-    if(not pv.at("post_ops").empty())
+    if(not post_op.field("post_ops").empty())
         return true;
-    auto v         = op.to_value();
-    auto last_op   = v.at("post_ops").empty() ? v : v.at("post_ops").back();
-    auto algo      = last_op.contains("algo") ? last_op.at("algo").to<std::string>() : op.name();
-    auto post_algo = pv["algo"].to<std::string>();
+    auto post_ops  = op.field("post_ops");
+    auto last_algo = post_ops.empty() ? op.field("algo") : post_ops.back().at("algo");
+    auto algo      = last_algo.is_null() ? op.name() : last_algo.to<std::string>();
+    auto post_algo = post_op.field("algo").to<std::string>();
     if(starts_with(algo, "eltwise") and starts_with(post_algo, "eltwise"))
         return true;
     if(algo == post_algo)
@@ -0,0 +1,262 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/fuse_reduce.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/dead_code_elimination.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/env.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/serialize.hpp>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+MIGRAPHX_DECLARE_ENV_VAR(MIGRAPHX_DISABLE_CPU_REDUCE_FUSION);
+
+static bool is_reduce(instruction_ref ins)
+{
+    return contains({"reduce_max", "reduce_mean", "reduce_min", "reduce_prod", "reduce_sum"},
+                    ins->name());
+}
+
+static std::vector<std::int64_t> reduce_axes(instruction_ref ins)
+{
+    return ins->get_operator().field("axes").to_vector<std::int64_t>();
+}
+
+struct reduce_group
+{
+    const std::unordered_map<instruction_ref, std::size_t>* positions = nullptr;
+    const std::unordered_set<instruction_ref>* fused                  = nullptr;
+    std::vector<std::int64_t> axes{};
+    // The shape that is reduced, and the shape of the result
+    std::vector<std::size_t> lens{};
+    std::vector<std::size_t> rlens{};
+    std::vector<instruction_ref> members{};
+    std::unordered_set<instruction_ref> member_set{};
+
+    std::size_t position(instruction_ref ins) const
+    {
+        auto it = positions->find(ins);
+        if(it == positions->end())
+            return 0;
+        return it->second;
+    }
+
+    auto by_position() const
+    {
+        return [this](auto x, auto y) { return position(x) < position(y); };
+    }
+
+    bool is_member(instruction_ref ins) const { return contains(member_set, ins); }
+
+    void add(instruction_ref ins)
+    {
+        members.push_back(ins);
+        member_set.insert(ins);
+    }
+
+    instruction_ref last_member() const
+    {
+        return *std::max_element(members.begin(), members.end(), by_position());
+    }
+
+    void remove(instruction_ref ins)
+    {
+        members.erase(std::find(members.begin(), members.end(), ins));
+        member_set.erase(ins);
+    }
+
+    bool fusable(instruction_ref ins) const
+    {
+        if(contains(*fused, ins) or not ins->module_inputs().empty())
+            return false;
+        if(ins->get_shape().type() != shape::float_type)
+            return false;
+        const auto& out_lens = ins->get_shape().lens();
+        if(is_reduce(ins))
+            return reduce_axes(ins) == axes and
+                   ins->inputs().front()->get_shape().lens() == lens;
+        if(ins->name() == "multibroadcast")
+            return out_lens == lens and ins->inputs().front()->get_shape().lens() == rlens and
+                   ins->inputs().front()->get_shape().type() == shape::float_type;
+        if(not fused_reduce_supports(ins->name()))
+            return false;
+        if(out_lens != lens and out_lens != rlens)
+            return false;
+        return all_of(ins->inputs(), [&](auto input) {
+            return input->get_shape().lens() == out_lens and
+                   input->get_shape().type() == shape::float_type;
+        });
+    }
+
+    // Pointwise producers are only fused when nothing else uses them
+    void add_producers(instruction_ref ins)
+    {
+        for(auto input : ins->inputs())
+        {
+            if(is_member(input) or is_reduce(input) or not fusable(input))
+                continue;
+            if(not all_of(input->outputs(), [&](auto output) { return is_member(output); }))
+                continue;
+            add(input);
+            add_producers(input);
+        }
+    }
+
+    // Instructions after the reduction are visited in order, so the ones outside of the group that
+    // use its members, directly or through other instructions, are known before their users. A
+    // consumer that takes one of them as an input can't be fused, since the group would then use
+    // a value computed from its own result.
+    void add_consumers(module& m, instruction_ref reduce)
+    {
+        std::unordered_set<instruction_ref> depends;
+        for(auto ins = std::next(reduce); ins != m.end(); ++ins)
+        {
+            bool uses_members = any_of(ins->inputs(), [&](auto input) { return is_member(input); });
+            bool uses_depends =
+                any_of(ins->inputs(), [&](auto input) { return contains(depends, input); });
+            if(uses_members and not uses_depends and fusable(ins))
+                add(ins);
+            else if(uses_members or uses_depends)
+                depends.insert(ins);
+        }
+    }
+
+    std::vector<instruction_ref> outputs() const
+    {
+        std::vector<instruction_ref> result;
+        std::copy_if(members.begin(), members.end(), std::back_inserter(result), [&](auto ins) {
+            return any_of(ins->outputs(), [&](auto output) { return not is_member(output); });
+        });
+        return result;
+    }
+
+    // Consumers are dropped from the end until only one member is used outside
+    // of the group
+    instruction_ref trim(instruction_ref reduce)
+    {
+        auto outs = outputs();
+        while(outs.size() > 1 and last_member() != reduce)
+        {
+            remove(last_member());
+            outs = outputs();
+        }
+        return outs.empty() ? reduce : outs.front();
+    }
+
+    bool worthwhile() const
+    {
+        return std::count_if(members.begin(), members.end(), [](auto ins) {
+                   return not contains({"contiguous", "multibroadcast"}, ins->name());
+               }) > 1;
+    }
+
+    void fuse(module_pass_manager& mpm, instruction_ref output, std::size_t n) const
+    {
+        auto& m     = mpm.get_module();
+        auto sorted = members;
+        std::sort(sorted.begin(), sorted.end(), by_position());
+        auto* sm = mpm.create_module(m.name() + ":fused_reduce" + std::to_string(n));
+        sm->set_bypass();
+
+        std::unordered_map<instruction_ref, instruction_ref> map_ins;
+        std::vector<instruction_ref> inputs;
+        for(auto ins : sorted)
+        {
+            for(auto input : ins->inputs())
+            {
+                if(contains(map_ins, input))
+                    continue;
+                map_ins[input] =
+                    sm->add_parameter("x" + std::to_string(inputs.size()), input->get_shape());
+                inputs.push_back(input);
+            }
+            std::vector<instruction_ref> args;
+            std::transform(ins->inputs().begin(),
+                           ins->inputs().end(),
+                           std::back_inserter(args),
+                           [&](auto input) { return map_ins.at(input); });
+            map_ins[ins] = sm->add_instruction(ins->get_operator(), args);
+        }
+        sm->add_return({map_ins.at(output)});
+
+        shape s{output->get_shape().type(), output->get_shape().lens()};
+        auto alloc = m.insert_instruction(output, make_op("allocate", {{"shape", to_value(s)}}));
+        inputs.push_back(alloc);
+        m.replace_instruction(output, make_op("cpu::fused_reduce", {{"axes", axes}}), inputs, {sm});
+    }
+};
+
+void fuse_reduce::apply(module_pass_manager& mpm) const
+{
+    if(enabled(MIGRAPHX_DISABLE_CPU_REDUCE_FUSION{}))
+        return;
+    auto& m = mpm.get_module();
+
+    std::unordered_set<instruction_ref> fused;
+    std::unordered_map<instruction_ref, std::size_t> positions;
+    std::vector<instruction_ref> reduces;
+    std::size_t i = 0;
+    for(auto ins : iterator_for(m))
+    {
+        positions[ins] = i++;
+        if(is_reduce(ins))
+            reduces.push_back(ins);
+    }
+
+    std::size_t n = 0;
+    for(auto reduce : reduces)
+    {
+        if(contains(fused, reduce))
+            continue;
+        reduce_group g{&positions, &fused};
+        g.axes  = reduce_axes(reduce);
+        g.lens  = reduce->inputs().front()->get_shape().lens();
+        g.rlens = reduce->get_shape().lens();
+        if(not g.fusable(reduce) or g.lens == g.rlens)
+            continue;
+        g.add(reduce);
+        g.add_producers(reduce);
+        g.add_consumers(m, reduce);
+        auto output = g.trim(reduce);
+        if(g.outputs().size() != 1 or not g.worthwhile())
+            continue;
+        g.fuse(mpm, output, n++);
+        // Fused instructions are left for dead code elimination, so they must
+        // not be fused again
+        fused.insert(g.members.begin(), g.members.end());
+    }
+    mpm.run_pass(dead_code_elimination{});
+}
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -0,0 +1,643 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/cpu/fuse_reduce.hpp>
+#include <migraphx/cpu/parallel.hpp>
+#include <migraphx/builtin.hpp>
+#include <migraphx/check_shapes.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/module.hpp>
+#include <migraphx/ranges.hpp>
+#include <migraphx/reflect.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/shape_for_each.hpp>
+#include <migraphx/stringutils.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <unordered_map>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+using unary_block  = void (*)(float*, const float*, std::size_t);
+using binary_block = void (*)(float*, const float*, const float*, std::size_t);
+
+// Each operator is applied to a whole block of the row at once, so the loop
+// can be vectorized instead of calling through a pointer for every element
+#define MIGRAPHX_CPU_UNARY_BLOCK(name, ...)                       \
+    {                                                             \
+        #name, [](float* y, const float* xs, std::size_t n) {     \
+            for(std::size_t i = 0; i < n; i++)                    \
+            {                                                     \
+                float x = xs[i];                                  \
+                y[i]    = __VA_ARGS__;                            \
+            }                                                     \
+        }                                                         \
+    }
+
+#define MIGRAPHX_CPU_BINARY_BLOCK(name, ...)                                      \
+    {                                                                             \
+        #name, [](float* z, const float* xs, const float* ys, std::size_t n) {    \
+            for(std::size_t i = 0; i < n; i++)                                    \
+            {                                                                     \
+                float x = xs[i];                                                  \
+                float y = ys[i];                                                  \
+                z[i]    = __VA_ARGS__;                                            \
+            }                                                                     \
+        }                                                                         \
+    }
+
+static const std::unordered_map<std::string, unary_block>& unary_blocks()
+{
+    static const std::unordered_map<std::string, unary_block> m = {
+        MIGRAPHX_CPU_UNARY_BLOCK(abs, std::abs(x)),
+        MIGRAPHX_CPU_UNARY_BLOCK(ceil, std::ceil(x)),
+        MIGRAPHX_CPU_UNARY_BLOCK(cos, std::cos(x)),
+        MIGRAPHX_CPU_UNARY_BLOCK(erf, std::erf(x)),
+        MIGRAPHX_CPU_UNARY_BLOCK(exp, std::exp(x)),
+        MIGRAPHX_CPU_UNARY_BLOCK(floor, std::floor(x)),
+        MIGRAPHX_CPU_UNARY_BLOCK(log, std::log(x)),
+        MIGRAPHX_CPU_UNARY_BLOCK(neg, -x),
+        MIGRAPHX_CPU_UNARY_BLOCK(recip, 1.0f / x),
+        MIGRAPHX_CPU_UNARY_BLOCK(relu, std::max(x, 0.0f)),
+        MIGRAPHX_CPU_UNARY_BLOCK(rsqrt, 1.0f / std::sqrt(x)),
+        MIGRAPHX_CPU_UNARY_BLOCK(sigmoid, 1.0f / (1.0f + std::exp(-x))),
+        MIGRAPHX_CPU_UNARY_BLOCK(sin, std::sin(x)),
+        MIGRAPHX_CPU_UNARY_BLOCK(sqrt, std::sqrt(x)),
+        MIGRAPHX_CPU_UNARY_BLOCK(tanh, std::tanh(x)),
+    };
+    return m;
+}
+
+static const std::unordered_map<std::string, binary_block>& binary_blocks()
+{
+    static const std::unordered_map<std::string, binary_block> m = {
+        MIGRAPHX_CPU_BINARY_BLOCK(add, x + y),
+        MIGRAPHX_CPU_BINARY_BLOCK(div, x / y),
+        MIGRAPHX_CPU_BINARY_BLOCK(max, std::max(x, y)),
+        MIGRAPHX_CPU_BINARY_BLOCK(min, std::min(x, y)),
+        MIGRAPHX_CPU_BINARY_BLOCK(mul, x * y),
+        MIGRAPHX_CPU_BINARY_BLOCK(pow, std::pow(x, y)),
+        MIGRAPHX_CPU_BINARY_BLOCK(sqdiff, (x - y) * (x - y)),
+        MIGRAPHX_CPU_BINARY_BLOCK(sub, x - y),
+    };
+    return m;
+}
+
+bool fused_reduce_supports(const std::string& name)
+{
+    return name == "contiguous" or contains(unary_blocks(), name) or
+           contains(binary_blocks(), name);
+}
+
+enum class reduce_algo
+{
+    sum,
+    mean,
+    max,
+    min,
+    prod
+};
+
+static reduce_algo get_reduce_algo(const std::string& name)
+{
+    if(name == "reduce_sum")
+        return reduce_algo::sum;
+    if(name == "reduce_mean")
+        return reduce_algo::mean;
+    if(name == "reduce_max")
+        return reduce_algo::max;
+    if(name == "reduce_min")
+        return reduce_algo::min;
+    if(name == "reduce_prod")
+        return reduce_algo::prod;
+    MIGRAPHX_THROW("cpu::fused_reduce: Unknown reduction: " + name);
+}
+
+// Independent lanes let the compiler vectorize the loop, and keep the partial
+// sums smaller than a single running total would be
+template <class F>
+static float reduce_lanes(float init, const float* x, std::size_t n, F f)
+{
+    std::array<float, 8> lanes;
+    lanes.fill(init);
+    std::size_t i = 0;
+    for(; i + lanes.size() <= n; i += lanes.size())
+    {
+        for(std::size_t l = 0; l < lanes.size(); l++)
+            lanes[l] = f(lanes[l], x[i + l]);
+    }
+    for(; i < n; i++)
+        lanes[0] = f(lanes[0], x[i]);
+    return std::accumulate(lanes.begin() + 1, lanes.end(), lanes[0], f);
+}
+
+static float reduce_init(reduce_algo algo)
+{
+    switch(algo)
+    {
+    case reduce_algo::sum:
+    case reduce_algo::mean: return 0.0f;
+    case reduce_algo::max: return std::numeric_limits<float>::lowest();
+    case reduce_algo::min: return std::numeric_limits<float>::max();
+    case reduce_algo::prod: return 1.0f;
+    }
+    MIGRAPHX_THROW("cpu::fused_reduce: Unknown reduction");
+}
+
+static float reduce_block(reduce_algo algo, float acc, const float* x, std::size_t n)
+{
+    switch(algo)
+    {
+    case reduce_algo::sum:
+    case reduce_algo::mean: return acc + reduce_lanes(0.0f, x, n, std::plus<>{});
+    case reduce_algo::max:
+        return std::max(acc, reduce_lanes(acc, x, n, [](float a, float b) {
+                            return std::max(a, b);
+                        }));
+    case reduce_algo::min:
+        return std::min(acc, reduce_lanes(acc, x, n, [](float a, float b) {
+                            return std::min(a, b);
+                        }));
+    case reduce_algo::prod: return acc * reduce_lanes(1.0f, x, n, std::multiplies<>{});
+    }
+    return acc;
+}
+
+// Where each row of an argument lives. A row is the elements that are reduced
+// together, and the other dimensions select the row.
+struct row_layout
+{
+    std::vector<std::size_t> outer_strides;
+    // Offset of each element in the row, which is empty when the row is
+    // contiguous
+    std::vector<std::size_t> inner;
+    bool broadcasted = false;
+
+    row_layout(const shape& s,
+               const std::vector<std::size_t>& lens,
+               const std::vector<std::int64_t>& axes,
+               bool row)
+    {
+        std::vector<std::size_t> inner_lens;
+        std::vector<std::size_t> inner_strides;
+        for(std::size_t d = 0; d < lens.size(); d++)
+        {
+            if(contains(axes, static_cast<std::int64_t>(d)))
+            {
+                inner_lens.push_back(lens[d]);
+                inner_strides.push_back(s.strides()[d]);
+            }
+            else
+            {
+                outer_strides.push_back(s.strides()[d]);
+            }
+        }
+        if(not row)
+            return;
+        shape is{shape::float_type, inner_lens, inner_strides};
+        inner.resize(is.elements());
+        std::size_t j = 0;
+        shape_for_each(shape{shape::float_type, inner_lens}, [&](const auto& idx) {
+            inner[j++] = is.index(idx);
+        });
+        if(std::all_of(inner.begin(), inner.end(), [](auto i) { return i == 0; }))
+        {
+            broadcasted = true;
+            inner.clear();
+        }
+        else if(is.standard())
+        {
+            inner.clear();
+        }
+    }
+
+    bool contiguous() const { return inner.empty() and not broadcasted; }
+
+    std::size_t outer_offset(std::size_t row, const std::vector<std::size_t>& outer_lens) const
+    {
+        std::size_t result = 0;
+        for(std::size_t d = outer_lens.size(); d > 0; d--)
+        {
+            result += (row % outer_lens[d - 1]) * outer_strides[d - 1];
+            row /= outer_lens[d - 1];
+        }
+        return result;
+    }
+};
+
+struct fused_step
+{
+    enum kind_t
+    {
+        param,
+        unary,
+        binary,
+        reduce,
+        broadcast
+    };
+    kind_t kind = param;
+    // Whether the step has a value for every element of the row, rather than
+    // one value per row
+    bool row        = true;
+    std::size_t arg = 0;
+    std::vector<std::size_t> inputs{};
+    // A null unary is a copy, so the input is used directly
+    unary_block unary_f   = nullptr;
+    binary_block binary_f = nullptr;
+    reduce_algo algo      = reduce_algo::sum;
+};
+
+// A reduction is computed in one pass over the row. The row steps it needs
+// are evaluated block by block into small buffers that stay in cache, and the
+// values that only exist once per row are computed between the passes.
+struct row_pass
+{
+    std::size_t target = 0;
+    std::vector<std::size_t> rows{};
+    std::vector<std::size_t> scalars_after{};
+};
+
+struct fused_reduce_plan
+{
+    static constexpr std::size_t block_size = 512;
+
+    std::vector<std::size_t> outer_lens;
+    std::size_t nrows     = 1;
+    std::size_t row_size  = 1;
+    std::size_t output    = 0;
+    std::vector<fused_step> steps;
+    std::vector<row_layout> layouts;
+    std::vector<std::size_t> scalars_before;
+    std::vector<row_pass> passes;
+
+    fused_reduce_plan(const module& m,
+                      const std::vector<shape>& inputs,
+                      const std::vector<std::int64_t>& axes)
+    {
+        auto first_reduce = std::find_if(m.begin(), m.end(), [](const auto& ins) {
+            return starts_with(ins.name(), "reduce_");
+        });
+        if(first_reduce == m.end())
+            MIGRAPHX_THROW("cpu::fused_reduce: Submodule has no reduction");
+        const auto& lens  = first_reduce->inputs().front()->get_shape().lens();
+        const auto& rlens = first_reduce->get_shape().lens();
+        for(std::size_t d = 0; d < lens.size(); d++)
+        {
+            if(contains(axes, static_cast<std::int64_t>(d)))
+                row_size *= lens[d];
+            else
+                outer_lens.push_back(lens[d]);
+        }
+        nrows = std::accumulate(
+            outer_lens.begin(), outer_lens.end(), std::size_t{1}, std::multiplies<>{});
+
+        auto is_row = [&](const shape& s) {
+            if(s.lens() == lens)
+                return true;
+            if(s.lens() == rlens)
+                return false;
+            MIGRAPHX_THROW("cpu::fused_reduce: Unexpected shape");
+        };
+        // The last input is the output
+        for(const auto& s : inputs)
+            layouts.emplace_back(s, lens, axes, is_row(s));
+
+        std::unordered_map<instruction_ref, std::size_t> step_of;
+        for(auto ins : iterator_for(m))
+        {
+            if(ins->name() == "@return")
+            {
+                output = step_of.at(ins->inputs().front());
+                continue;
+            }
+            fused_step step;
+            step.row = is_row(ins->get_shape());
+            std::transform(ins->inputs().begin(),
+                           ins->inputs().end(),
+                           std::back_inserter(step.inputs),
+                           [&](auto input) { return step_of.at(input); });
+            if(ins->name() == "@param")
+            {
+                step.kind = fused_step::param;
+                step.arg  = std::stoul(any_cast<builtin::param>(ins->get_operator())
+                                          .parameter.substr(1));
+            }
+            else if(starts_with(ins->name(), "reduce_"))
+            {
+                step.kind = fused_step::reduce;
+                step.algo = get_reduce_algo(ins->name());
+            }
+            else if(ins->name() == "multibroadcast")
+            {
+                step.kind = fused_step::broadcast;
+            }
+            else if(ins->name() == "contiguous")
+            {
+                step.kind = fused_step::unary;
+            }
+            else if(contains(unary_blocks(), ins->name()))
+            {
+                step.kind    = fused_step::unary;
+                step.unary_f = unary_blocks().at(ins->name());
+            }
+            else if(contains(binary_blocks(), ins->name()))
+            {
+                step.kind     = fused_step::binary;
+                step.binary_f = binary_blocks().at(ins->name());
+            }
+            else
+            {
+                MIGRAPHX_THROW("cpu::fused_reduce: Unsupported operator: " + ins->name());
+            }
+            step_of[ins] = steps.size();
+            steps.push_back(step);
+        }
+
+        // The pass after which each value per row can be computed
+        std::vector<std::size_t> level(steps.size(), 0);
+        for(std::size_t i = 0; i < steps.size(); i++)
+        {
+            const auto& step = steps[i];
+            if(step.kind == fused_step::reduce)
+            {
+                passes.push_back({i});
+                level[i] = passes.size();
+            }
+            else if(not step.row)
+            {
+                for(auto input : step.inputs)
+                    level[i] = std::max(level[i], level[input]);
+            }
+        }
+        if(steps.at(output).row)
+            passes.push_back({output});
+        for(std::size_t i = 0; i < steps.size(); i++)
+        {
+            if(steps[i].row or steps[i].kind == fused_step::reduce)
+                continue;
+            if(level[i] == 0)
+                scalars_before.push_back(i);
+            else
+                passes[level[i] - 1].scalars_after.push_back(i);
+        }
+        for(auto& p : passes)
+            p.rows = needed_rows(p.target);
+    }
+
+    std::vector<std::size_t> needed_rows(std::size_t target) const
+    {
+        std::vector<bool> needed(steps.size(), false);
+        std::vector<std::size_t> stack = {target};
+        while(not stack.empty())
+        {
+            auto i = stack.back();
+            stack.pop_back();
+            if(needed[i])
+                continue;
+            if(i != target and not steps[i].row)
+                continue;
+            needed[i] = true;
+            stack.insert(stack.end(), steps[i].inputs.begin(), steps[i].inputs.end());
+        }
+        std::vector<std::size_t> result;
+        for(std::size_t i = 0; i < steps.size(); i++)
+        {
+            if(needed[i] and steps[i].row)
+                result.push_back(i);
+        }
+        return result;
+    }
+
+    void run(const std::vector<const float*>& data, float* out) const
+    {
+        const std::size_t min_grain = std::max<std::size_t>(1, 4096 / row_size);
+        cpu::parallel_for(nrows, min_grain, [&](std::size_t start, std::size_t end) {
+            std::vector<float> buffer(steps.size() * block_size);
+            std::vector<const float*> values(steps.size());
+            std::vector<float> scalars(steps.size());
+            std::vector<std::size_t> bases(layouts.size());
+            for(std::size_t r = start; r < end; r++)
+            {
+                std::transform(layouts.begin(), layouts.end(), bases.begin(), [&](const auto& l) {
+                    return l.outer_offset(r, outer_lens);
+                });
+                for(auto i : scalars_before)
+                    eval_scalar(i, data, bases, scalars);
+                for(const auto& p : passes)
+                {
+                    const auto& target = steps[p.target];
+                    float acc          = target.row ? 0.0f : reduce_init(target.algo);
+                    for(std::size_t j = 0; j < row_size; j += block_size)
+                    {
+                        auto n = std::min(block_size, row_size - j);
+                        for(auto i : p.rows)
+                            eval_row(i, j, n, data, bases, scalars, buffer, values);
+                        if(target.row)
+                            write_row(values[p.target], j, n, out + bases.back());
+                        else
+                            acc = reduce_block(
+                                target.algo, acc, values[target.inputs.front()], n);
+                    }
+                    if(not target.row)
+                        scalars[p.target] =
+                            target.algo == reduce_algo::mean ? acc / row_size : acc;
+                    for(auto i : p.scalars_after)
+                        eval_scalar(i, data, bases, scalars);
+                }
+                if(not steps[output].row)
+                    out[bases.back()] = scalars[output];
+            }
+        });
+    }
+
+    void eval_scalar(std::size_t i,
+                     const std::vector<const float*>& data,
+                     const std::vector<std::size_t>& bases,
+                     std::vector<float>& scalars) const
+    {
+        const auto& step = steps[i];
+        switch(step.kind)
+        {
+        case fused_step::param: scalars[i] = data[step.arg][bases[step.arg]]; break;
+        case fused_step::unary:
+            if(step.unary_f == nullptr)
+                scalars[i] = scalars[step.inputs.front()];
+            else
+                step.unary_f(&scalars[i], &scalars[step.inputs.front()], 1);
+            break;
+        case fused_step::binary:
+            step.binary_f(&scalars[i], &scalars[step.inputs[0]], &scalars[step.inputs[1]], 1);
+            break;
+        case fused_step::reduce:
+        case fused_step::broadcast: break;
+        }
+    }
+
+    void eval_row(std::size_t i,
+                  std::size_t j,
+                  std::size_t n,
+                  const std::vector<const float*>& data,
+                  const std::vector<std::size_t>& bases,
+                  const std::vector<float>& scalars,
+                  std::vector<float>& buffer,
+                  std::vector<const float*>& values) const
+    {
+        const auto& step = steps[i];
+        float* y         = buffer.data() + i * block_size;
+        values[i]        = y;
+        switch(step.kind)
+        {
+        case fused_step::param: {
+            const auto& layout = layouts[step.arg];
+            const float* x     = data[step.arg] + bases[step.arg];
+            if(layout.contiguous())
+                values[i] = x + j;
+            else if(layout.broadcasted)
+                std::fill(y, y + n, x[0]);
+            else
+                std::transform(layout.inner.begin() + j,
+                               layout.inner.begin() + j + n,
+                               y,
+                               [&](auto offset) { return x[offset]; });
+            break;
+        }
+        case fused_step::unary:
+            if(step.unary_f == nullptr)
+                values[i] = values[step.inputs.front()];
+            else
+                step.unary_f(y, values[step.inputs.front()], n);
+            break;
+        case fused_step::binary:
+            step.binary_f(y, values[step.inputs[0]], values[step.inputs[1]], n);
+            break;
+        case fused_step::broadcast: std::fill(y, y + n, scalars[step.inputs.front()]); break;
+        case fused_step::reduce: break;
+        }
+    }
+
+    void write_row(const float* x, std::size_t j, std::size_t n, float* out) const
+    {
+        const auto& layout = layouts.back();
+        if(layout.contiguous())
+            std::copy(x, x + n, out + j);
+        else
+            for(std::size_t k = 0; k < n; k++)
+                out[layout.inner[j + k]] = x[k];
+    }
+};
+
+// The plan only depends on the submodule and the shapes, which are fixed once the program is
+// compiled, so it is built on the first eval and reused until they change. Copies of the operator share it, and
+// the lock lets copied programs run on several threads.
+struct fused_reduce_cache
+{
+    std::mutex m;
+    const module* mod = nullptr;
+    std::vector<shape> shapes;
+    std::shared_ptr<const fused_reduce_plan> plan;
+};
+
+struct fused_reduce
+{
+    std::vector<std::int64_t> axes{};
+    std::shared_ptr<fused_reduce_cache> cache = std::make_shared<fused_reduce_cache>();
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return pack(f(self.axes, "axes"));
+    }
+
+    std::string name() const { return "cpu::fused_reduce"; }
+
+    shape compute_shape(const std::vector<shape>& inputs, std::vector<module_ref> mods) const
+    {
+        if(mods.size() != 1)
+            MIGRAPHX_THROW("should have one submodule.");
+        const auto* sm = mods.front();
+        if(sm->get_output_shapes().size() != 1)
+            MIGRAPHX_THROW("submodule should have only one output.");
+        check_shapes{inputs, *this}.has(sm->get_parameter_names().size() + 1);
+        if(sm->get_output_shapes().front().lens() != inputs.back().lens())
+            MIGRAPHX_THROW("cpu::fused_reduce: Allocation doesn't match the submodule output");
+        return inputs.back();
+    }
+
+    argument compute(const shape&,
+                     const std::vector<argument>& args,
+                     const std::vector<module_ref>& mods,
+                     const std::function<std::vector<argument>(
+                         module_ref&, const std::unordered_map<std::string, argument>&)>&) const
+    {
+        auto plan = get_plan(*mods.front(), args);
+        std::vector<const float*> data;
+        std::transform(args.begin(), args.end(), std::back_inserter(data), [](const auto& arg) {
+            return reinterpret_cast<const float*>(arg.data());
+        });
+        auto result = args.back();
+        plan->run(data, reinterpret_cast<float*>(result.data()));
+        return result;
+    }
+
+    std::shared_ptr<const fused_reduce_plan> get_plan(const module& m,
+                                                      const std::vector<argument>& args) const
+    {
+        std::lock_guard<std::mutex> lock(cache->m);
+        bool same_shapes =
+            cache->plan != nullptr and cache->mod == &m and
+            std::equal(args.begin(),
+                       args.end(),
+                       cache->shapes.begin(),
+                       cache->shapes.end(),
+                       [](const auto& arg, const auto& s) { return arg.get_shape() == s; });
+        if(not same_shapes)
+        {
+            cache->mod = &m;
+            cache->shapes.clear();
+            std::transform(args.begin(),
+                           args.end(),
+                           std::back_inserter(cache->shapes),
+                           [](const auto& arg) { return arg.get_shape(); });
+            cache->plan = std::make_shared<fused_reduce_plan>(m, cache->shapes, axes);
+        }
+        return cache->plan;
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+MIGRAPHX_REGISTER_OP(fused_reduce)
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
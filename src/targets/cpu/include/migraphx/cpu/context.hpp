@@ -28,6 +28,7 @@
 #include <migraphx/cpu/dnnl.hpp>
 #include <migraphx/cpu/parallel.hpp>
 #include <migraphx/par_for.hpp>
+#include <migraphx/value.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -35,8 +36,20 @@ namespace cpu {
 
 struct context
 {
+    /// Threads used by the operators, or 0 to use every core. Setting it with from_value applies
+    /// it to the calling thread, so a program run on its own thread should set it there.
+    std::size_t threads = 0;
+
     void finish() const {}
 
+    value to_value() const { return {{"threads", threads}}; }
+    void from_value(const value& v)
+    {
+        threads = v.get("threads", threads);
+        if(threads > 0)
+            set_max_threads(threads);
+    }
+
     template <class F>
     void bulk_execute(std::size_t n, std::size_t min_grain, F f)
     {
@@ -125,7 +125,8 @@ struct dnnl_op : auto_register_op<Derived>
         auto g           = self.group();
         if(not names.empty())
             g += "<" + join_strings(names, ",") + ">";
-        return {{"group", g}};
+        // Creating a primitive only reads the shared engine
+        return {{"group", g}, {"threadsafe_finalize", true}};
     }
 
     std::size_t get_extra_post_op_args() const
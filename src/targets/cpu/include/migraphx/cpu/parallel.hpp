@@ -27,6 +27,7 @@
 // #define MIGRAPHX_DISABLE_OMP
 
 #include <migraphx/config.hpp>
+#include <cmath>
 #ifdef MIGRAPHX_DISABLE_OMP
 #include <migraphx/par_for.hpp>
 #else
@@ -48,7 +49,21 @@ namespace cpu {
 
 #ifdef MIGRAPHX_DISABLE_OMP
 
-inline std::size_t max_threads() { return std::thread::hardware_concurrency(); }
+inline std::size_t& thread_limit()
+{
+    static thread_local std::size_t n = 0;
+    return n;
+}
+
+inline std::size_t max_threads()
+{
+    if(thread_limit() > 0)
+        return thread_limit();
+    return std::thread::hardware_concurrency();
+}
+
+// Limits the threads used by parallel_for on the calling thread
+inline void set_max_threads(std::size_t n) { thread_limit() = n; }
 
 template <class F>
 void parallel_for_impl(std::size_t n, std::size_t threadsize, F f)
@@ -81,6 +96,9 @@ void parallel_for_impl(std::size_t n, std::size_t threadsize, F f)
 
 inline std::size_t max_threads() { return omp_get_max_threads(); }
 
+// Limits the threads used by parallel_for on the calling thread
+inline void set_max_threads(std::size_t n) { omp_set_num_threads(static_cast<int>(n)); }
+
 template <class F>
 void parallel_for_impl(std::size_t n, std::size_t threadsize, F f)
 {
@@ -91,7 +109,7 @@ void parallel_for_impl(std::size_t n, std::size_t threadsize, F f)
     else
     {
         std::size_t grainsize = std::ceil(static_cast<double>(n) / threadsize);
-#pragma omp parallel for num_threads(threadsize) schedule(static, 1) private(grainsize, n)
+#pragma omp parallel for num_threads(threadsize) schedule(static, 1) firstprivate(grainsize, n)
         for(std::size_t tid = 0; tid < threadsize; tid++)
         {
             std::size_t work = tid * grainsize;
@@ -390,6 +390,8 @@ struct cpu_apply
                               {"reduce_sum", "reduction_sum"},
                           });
 
+        extend_op("argmax", "cpu::argmax");
+        extend_op("argmin", "cpu::argmin");
         extend_op("concat", "dnnl::concat");
         extend_op("contiguous", "dnnl::reorder");
         extend_op("convolution", "dnnl::convolution");
@@ -401,6 +403,7 @@ struct cpu_apply
         extend_op("gather", "cpu::gather");
         extend_op("logsoftmax", "dnnl::logsoftmax");
         extend_op("lrn", "dnnl::lrn");
+        extend_op("nonzero", "cpu::nonzero");
         extend_op("softmax", "dnnl::softmax");
         extend_op("sub", "cpu::sub");
 
@@ -408,6 +411,7 @@ struct cpu_apply
         extend_op("leaky_relu", "cpu::leaky_relu", false);
         extend_op("pad", "cpu::pad", false);
         extend_op("rnn_var_sl_last_output", "cpu::rnn_var_sl_last_output", false);
+        extend_op("topk", "cpu::topk", false);
     }
 
     void apply()
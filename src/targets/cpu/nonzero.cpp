@@ -0,0 +1,122 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/config.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/op/nonzero.hpp>
+#include <algorithm>
+#include <numeric>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+struct cpu_nonzero : auto_register_op<cpu_nonzero>
+{
+    op::nonzero op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+    std::string name() const { return "cpu::" + op.name(); }
+    shape compute_shape(std::vector<shape> inputs) const
+    {
+        // Compensate for allocation
+        inputs.pop_back();
+        return migraphx::compute_shape(op, inputs);
+    }
+
+    // Two passes over the same chunks: count the nonzero elements of each chunk, then write
+    // the indices of each chunk at the offset given by the counts before it
+    argument compute(context& ctx, const shape&, const std::vector<argument>& args) const
+    {
+        auto in_s        = args.front().get_shape();
+        const auto& lens = in_s.lens();
+        std::size_t n    = in_s.elements();
+        std::size_t ndim = lens.size();
+        auto* output     = args.back().cast<int64_t>();
+        std::size_t grain = 16384;
+        std::size_t nchunks =
+            std::max<std::size_t>(1, std::min(max_threads(), (n + grain - 1) / grain));
+        std::size_t chunk = (n + nchunks - 1) / nchunks;
+        std::vector<std::size_t> offsets(nchunks + 1, 0);
+        args.front().visit([&](auto input) {
+            const auto* x = input.data();
+            ctx.bulk_execute(nchunks, 1, [&](auto start, auto end) {
+                for(auto c = start; c < end; c++)
+                {
+                    std::size_t first = std::min(n, c * chunk);
+                    std::size_t last  = std::min(n, first + chunk);
+                    offsets[c + 1]    = std::count_if(
+                        x + first, x + last, [](auto v) { return not float_equal(v, 0); });
+                }
+            });
+            std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+            ctx.bulk_execute(nchunks, 1, [&](auto start, auto end) {
+                for(auto c = start; c < end; c++)
+                {
+                    std::size_t first = std::min(n, c * chunk);
+                    std::size_t last  = std::min(n, first + chunk);
+                    std::size_t pos   = offsets[c];
+                    if(first == last)
+                        continue;
+                    auto idx = in_s.multi(first);
+                    for(auto i = first; i < last; i++)
+                    {
+                        if(not float_equal(x[i], 0))
+                        {
+                            for(std::size_t d = 0; d < ndim; d++)
+                                output[d * n + pos] = idx[d];
+                            pos++;
+                        }
+                        // Advance the multi-index to the next element
+                        for(std::size_t d = ndim; d > 0; d--)
+                        {
+                            if(++idx[d - 1] < lens[d - 1])
+                                break;
+                            idx[d - 1] = 0;
+                        }
+                    }
+                }
+            });
+        });
+        // The rest of each row is zero filled, as in the reference op
+        std::size_t total = offsets.back();
+        for(std::size_t d = 0; d < ndim; d++)
+            std::fill(output + d * n + total, output + (d + 1) * n, 0);
+        return args.back();
+    }
+
+    std::ptrdiff_t output_alias(const std::vector<shape>& shapes) const
+    {
+        return shapes.size() - 1;
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
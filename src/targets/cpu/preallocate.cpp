@@ -52,6 +52,7 @@ struct cpu_preallocate : auto_register_op<cpu_preallocate>
     }
     argument compute(context&, const shape&, const std::vector<argument>&) const { return data; }
     void finalize(context&, const shape&, const std::vector<shape>&) { data = argument(s); }
+    value attributes() const { return {{"threadsafe_finalize", true}}; }
     lifetime get_lifetime() const { return lifetime::global; }
 };
 
@@ -47,6 +47,7 @@
 #include <migraphx/simplify_reshapes.hpp>
 #include <migraphx/preallocate_param.hpp>
 #include <migraphx/cpu/fuse_ops.hpp>
+#include <migraphx/cpu/fuse_reduce.hpp>
 #include <migraphx/cpu/write_literals.hpp>
 #include <migraphx/cpu/allocation_model.hpp>
 #include <migraphx/cpu/target.hpp>
@@ -55,6 +56,8 @@
 #include <migraphx/pass.hpp>
 #include <migraphx/generate.hpp>
 #include <migraphx/normalize_ops.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/module.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -88,6 +91,8 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
             simplify_reshapes{},
             propagate_constant{},
             dead_code_elimination{},
+            fuse_reduce{},
+            dead_code_elimination{},
             lowering{},
             eliminate_contiguous{"dnnl::reorder"},
             dead_code_elimination{},
@@ -107,6 +112,19 @@ std::vector<pass> target::get_passes(migraphx::context& gctx, const compile_opti
 
 argument target::allocate(const shape& s) const { return fill_argument(s, 0); }
 
+supported_segments target::find_supported(const_module_ref mod, support_metric) const
+{
+    // Other types are converted to float by eliminate_data_type, so leave them to other targets
+    supported_segment instrs;
+    for(const auto ins : iterator_for(*mod))
+    {
+        if(ins->get_shape().type() == shape::float_type)
+            instrs.instructions.insert(ins);
+    }
+    instrs.metric = 1;
+    return {instrs};
+}
+
 MIGRAPHX_REGISTER_TARGET(target);
 
 } // namespace cpu
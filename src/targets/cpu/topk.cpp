@@ -0,0 +1,257 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/config.hpp>
+#include <migraphx/context.hpp>
+#include <migraphx/cpu/context.hpp>
+#include <migraphx/register_op.hpp>
+#include <migraphx/op/topk.hpp>
+#include <algorithm>
+#include <numeric>
+
+namespace migraphx {
+inline namespace MIGRAPHX_INLINE_NS {
+namespace cpu {
+
+// Orders candidates best first; equal values keep the lower index first
+template <class T>
+struct topk_compare
+{
+    bool largest = true;
+
+    bool better(T x, T y) const { return largest ? y < x : x < y; }
+
+    bool operator()(T x, int64_t i, T y, int64_t j) const
+    {
+        if(better(x, y))
+            return true;
+        if(better(y, x))
+            return false;
+        return i < j;
+    }
+};
+
+// Keeps the best k candidates sorted. Equal values must be pushed in increasing index order, so
+// a value equal to one already kept is placed after it and never displaces the current worst.
+template <class T>
+struct topk_selection
+{
+    topk_compare<T> compare;
+    std::size_t k = 0;
+    std::vector<T> values;
+    std::vector<int64_t> indices;
+
+    topk_selection(topk_compare<T> c, std::size_t n) : compare(c), k(n)
+    {
+        values.reserve(k);
+        indices.reserve(k);
+    }
+
+    bool full() const { return values.size() == k; }
+
+    void push(T x, int64_t i)
+    {
+        if(full())
+        {
+            if(not compare.better(x, values.back()))
+                return;
+            values.pop_back();
+            indices.pop_back();
+        }
+        auto pos = std::upper_bound(
+            values.begin(), values.end(), x, [&](T a, T b) { return compare.better(a, b); });
+        auto offset = pos - values.begin();
+        values.insert(pos, x);
+        indices.insert(indices.begin() + offset, i);
+    }
+
+    // Once full, whole blocks are tested against the current worst value with a branch free
+    // loop that vectorizes; only blocks with a candidate that beats it are inserted one by one
+    void scan(const T* x, std::size_t n, int64_t first)
+    {
+        constexpr std::size_t block = 16;
+        std::size_t i               = 0;
+        for(; i < n and not full(); i++)
+            push(x[i], first + i);
+        for(; i + block <= n; i += block)
+        {
+            T worst  = values.back();
+            bool hit = false;
+            for(std::size_t j = 0; j < block; j++)
+                hit |= compare.better(x[i + j], worst);
+            if(not hit)
+                continue;
+            for(std::size_t j = 0; j < block; j++)
+                push(x[i + j], first + i + j);
+        }
+        for(; i < n; i++)
+            push(x[i], first + i);
+    }
+};
+
+struct cpu_topk : auto_register_op<cpu_topk>
+{
+    op::topk op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+    std::string name() const { return "cpu::" + op.name(); }
+    shape compute_shape(const std::vector<shape>& inputs) const
+    {
+        return migraphx::compute_shape(op, inputs);
+    }
+
+    // Candidate selection above this k costs more than a full partition of the slice
+    static constexpr std::size_t max_selection_k = 128;
+    // Axis length from which a single slice is split across threads
+    static constexpr std::size_t split_size = 65536;
+
+    template <class T>
+    static void select(topk_compare<T> compare,
+                       const T* x,
+                       std::size_t n,
+                       std::size_t k,
+                       std::vector<int64_t>& order,
+                       T* out_val,
+                       int64_t* out_ind,
+                       std::size_t out_stride)
+    {
+        if(k <= max_selection_k and k * 8 <= n)
+        {
+            topk_selection<T> sel{compare, k};
+            sel.scan(x, n, 0);
+            for(std::size_t j = 0; j < k; j++)
+            {
+                out_val[j * out_stride] = sel.values[j];
+                out_ind[j * out_stride] = sel.indices[j];
+            }
+            return;
+        }
+        order.resize(n);
+        std::iota(order.begin(), order.end(), 0);
+        auto cmp = [&](int64_t i, int64_t j) { return compare(x[i], i, x[j], j); };
+        if(k < n)
+            std::nth_element(order.begin(), order.begin() + k, order.end(), cmp);
+        std::sort(order.begin(), order.begin() + k, cmp);
+        for(std::size_t j = 0; j < k; j++)
+        {
+            out_val[j * out_stride] = x[order[j]];
+            out_ind[j * out_stride] = order[j];
+        }
+    }
+
+    argument
+    compute(context& ctx, const shape& output_shape, const std::vector<argument>& args) const
+    {
+        auto vec_ss = output_shape.sub_shapes();
+        argument res_val{vec_ss.front()};
+        argument res_ind{vec_ss.back()};
+        auto in_s         = args.front().get_shape();
+        std::size_t n     = in_s.lens()[op.axis];
+        std::size_t k     = op.k;
+        std::size_t inner = in_s.strides()[op.axis];
+        std::size_t outer = in_s.elements() / (n * inner);
+        std::size_t rows  = outer * inner;
+
+        visit_all(res_val, args.front())([&](auto output, auto input) {
+            using type = typename decltype(input)::value_type;
+            topk_compare<type> compare{op.largest};
+            const type* x = input.data();
+            type* out_val = output.data();
+            auto* out_ind = res_ind.cast<int64_t>();
+            std::size_t nchunks =
+                std::min(max_threads(), n / std::max<std::size_t>(split_size / 4, 8 * k));
+            if(inner == 1 and rows < max_threads() and n >= split_size and k <= max_selection_k and
+               nchunks > 1)
+            {
+                split_select(ctx, compare, x, n, k, rows, nchunks, out_val, out_ind);
+                return;
+            }
+            ctx.bulk_execute(rows, std::max<std::size_t>(1, 4096 / n), [&](auto start, auto end) {
+                std::vector<type> slice(inner == 1 ? 0 : n);
+                std::vector<int64_t> order;
+                for(auto r = start; r < end; r++)
+                {
+                    std::size_t o = r / inner;
+                    std::size_t i = r % inner;
+                    const type* s = x + o * n * inner + i;
+                    if(inner != 1)
+                    {
+                        for(std::size_t j = 0; j < n; j++)
+                            slice[j] = s[j * inner];
+                        s = slice.data();
+                    }
+                    auto offset = o * k * inner + i;
+                    select(compare, s, n, k, order, out_val + offset, out_ind + offset, inner);
+                }
+            });
+        });
+
+        return {{res_val, res_ind}};
+    }
+
+    // A few very long slices: select within chunks of the axis in parallel, then merge the
+    // per-chunk candidates in chunk order, which preserves the lower index first tie break
+    template <class T>
+    static void split_select(context& ctx,
+                             topk_compare<T> compare,
+                             const T* x,
+                             std::size_t n,
+                             std::size_t k,
+                             std::size_t rows,
+                             std::size_t nchunks,
+                             T* out_val,
+                             int64_t* out_ind)
+    {
+        std::size_t chunk = (n + nchunks - 1) / nchunks;
+        std::vector<topk_selection<T>> partial(nchunks, topk_selection<T>{compare, k});
+        for(std::size_t r = 0; r < rows; r++)
+        {
+            const T* s = x + r * n;
+            ctx.bulk_execute(nchunks, 1, [&](auto start, auto end) {
+                for(auto c = start; c < end; c++)
+                {
+                    std::size_t first = c * chunk;
+                    partial[c].values.clear();
+                    partial[c].indices.clear();
+                    partial[c].scan(s + first, std::min(chunk, n - first), first);
+                }
+            });
+            topk_selection<T> sel{compare, k};
+            for(const auto& p : partial)
+            {
+                for(std::size_t j = 0; j < p.values.size(); j++)
+                    sel.push(p.values[j], p.indices[j]);
+            }
+            std::copy(sel.values.begin(), sel.values.end(), out_val + r * k);
+            std::copy(sel.indices.begin(), sel.indices.end(), out_ind + r * k);
+        }
+    }
+};
+
+} // namespace cpu
+} // namespace MIGRAPHX_INLINE_NS
+} // namespace migraphx
@@ -26,7 +26,7 @@
 #include <migraphx/module.hpp>
 #include <migraphx/iterator_for.hpp>
 #include <migraphx/instruction.hpp>
-#include <migraphx/par_for.hpp>
+#include <migraphx/job_server.hpp>
 #include <migraphx/register_op.hpp>
 #include <migraphx/op/identity.hpp>
 #include <migraphx/gpu/compiler.hpp>
@@ -72,9 +72,7 @@ struct compiled_result
 template <class F>
 void par_compile(std::size_t n, F f)
 {
-    if(n == 0)
-        return;
-    par_for(n, n / value_of(MIGRAPHX_GPU_COMPILE_PARALLEL{}, n), f);
+    job_server{value_of(MIGRAPHX_GPU_COMPILE_PARALLEL{})}.run(n, f);
 }
 
 void compile_ops::apply(module& m) const
@@ -176,7 +176,7 @@ hip_ptr write_to_gpu(const T& x)
 argument allocate_gpu(const shape& s, bool host)
 {
     auto p = allocate_gpu(s.bytes() + 1, host);
-    return {s, [p]() mutable { return reinterpret_cast<char*>(p.get()); }};
+    return {s, p};
 }
 
 argument register_on_gpu(const argument& arg)
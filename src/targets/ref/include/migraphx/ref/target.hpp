@@ -44,6 +44,7 @@ struct target
     argument copy_to(const argument& arg) const { return arg; }
     argument copy_from(const argument& arg) const { return arg; }
     argument allocate(const shape& s) const;
+    supported_segments find_supported(const_module_ref mod, support_metric m) const;
 };
 
 MIGRAPHX_REGISTER_TARGET(target);
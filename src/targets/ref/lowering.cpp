@@ -52,6 +52,7 @@
 #include <migraphx/tune_axis.hpp>
 #include <migraphx/pad_calc.hpp>
 
+#include <numeric>
 #include <unordered_map>
 #include <utility>
 #include <iostream>
@@ -134,6 +135,202 @@ auto visit_quantize(T&& x, Ts&&... xs)
     };
 }
 
+// Type used to accumulate the products of the fast convolution kernels
+template <class T>
+using conv_acc_type = std::conditional_t<std::is_integral<T>{}, std::int64_t, double>;
+
+// Spatial dimensions of a convolution, with the input being the side that is gathered by im2col
+struct conv_window
+{
+    std::vector<std::size_t> in_lens;
+    std::vector<std::size_t> out_lens;
+    std::vector<std::size_t> kernel;
+    std::vector<std::size_t> stride;
+    std::vector<std::size_t> padding;
+    std::vector<std::size_t> dilation;
+
+    conv_window(const std::vector<std::size_t>& input,
+                const std::vector<std::size_t>& output,
+                const std::vector<std::size_t>& weights,
+                std::vector<std::size_t> pstride,
+                std::vector<std::size_t> ppadding,
+                std::vector<std::size_t> pdilation)
+        : in_lens(input.begin() + 2, input.end()),
+          out_lens(output.begin() + 2, output.end()),
+          kernel(weights.begin() + 2, weights.end()),
+          stride(std::move(pstride)),
+          padding(std::move(ppadding)),
+          dilation(std::move(pdilation))
+    {
+    }
+
+    std::size_t kdims() const { return kernel.size(); }
+
+    static std::size_t elements(const std::vector<std::size_t>& lens)
+    {
+        return std::accumulate(
+            lens.begin(), lens.end(), std::size_t{1}, std::multiplies<std::size_t>{});
+    }
+
+    // Position in the input of an output index and kernel index along dimension d
+    std::ptrdiff_t input_pos(std::size_t d, std::size_t o, std::size_t k) const
+    {
+        return std::ptrdiff_t(o * stride[d] + k * dilation[d]) - std::ptrdiff_t(padding[d]);
+    }
+
+    bool in_range(std::size_t d, std::ptrdiff_t i) const
+    {
+        return i >= 0 and i < std::ptrdiff_t(in_lens[d]);
+    }
+
+    // Calls f(row, in_offset, valid) for each row of the output (the last dimension), where
+    // in_offset is the offset of the input for the outer dimensions, and valid is false when the
+    // row falls in the padding
+    template <class F>
+    void for_each_row(const std::vector<std::size_t>& kidx, F f) const
+    {
+        auto n = kdims();
+        std::vector<std::size_t> oidx(n, 0);
+        std::size_t rows = elements(out_lens) / out_lens.back();
+        for(std::size_t r = 0; r < rows; r++)
+        {
+            std::ptrdiff_t offset = 0;
+            bool valid            = true;
+            for(std::size_t d = 0; d + 1 < n; d++)
+            {
+                auto i = input_pos(d, oidx[d], kidx[d]);
+                valid  = valid and in_range(d, i);
+                offset = offset * in_lens[d] + i;
+            }
+            f(r, offset * in_lens.back(), valid);
+            // Advance the index of the outer dimensions
+            for(std::size_t d = n - 1; d > 0; d--)
+            {
+                if(++oidx[d - 1] < out_lens[d - 1])
+                    break;
+                oidx[d - 1] = 0;
+            }
+        }
+    }
+
+    void kernel_index(std::size_t k, std::vector<std::size_t>& kidx) const
+    {
+        for(std::size_t d = kdims(); d > 0; d--)
+        {
+            kidx[d - 1] = k % kernel[d - 1];
+            k /= kernel[d - 1];
+        }
+    }
+};
+
+// Gathers the input windows of one group into col, which has channels * kernel size rows and one
+// column per output position
+template <class T, class U>
+void conv_im2col(U* col, const T* input, std::size_t channels, const conv_window& w)
+{
+    auto ksize   = conv_window::elements(w.kernel);
+    auto in_size = conv_window::elements(w.in_lens);
+    auto cols    = conv_window::elements(w.out_lens);
+    auto last    = w.kdims() - 1;
+    auto width   = w.out_lens.back();
+    par_for(channels * ksize, 1, [&](auto k) {
+        std::vector<std::size_t> kidx(w.kdims());
+        w.kernel_index(k % ksize, kidx);
+        const T* in = input + (k / ksize) * in_size;
+        U* out      = col + k * cols;
+        w.for_each_row(kidx, [&](auto r, auto offset, auto valid) {
+            U* out_row = out + r * width;
+            if(not valid)
+            {
+                std::fill(out_row, out_row + width, U{0});
+                return;
+            }
+            for(std::size_t x = 0; x < width; x++)
+            {
+                auto i     = w.input_pos(last, x, kidx[last]);
+                out_row[x] = w.in_range(last, i) ? U(in[offset + i]) : U{0};
+            }
+        });
+    });
+}
+
+// Scatters the columns of one group into output, which is the inverse of conv_im2col. The output
+// of a transposed convolution is the side of the window gathered by im2col.
+template <class T>
+void conv_col2im(T* output, const T* col, std::size_t channels, const conv_window& w)
+{
+    auto ksize    = conv_window::elements(w.kernel);
+    auto out_size = conv_window::elements(w.in_lens);
+    auto cols     = conv_window::elements(w.out_lens);
+    auto last     = w.kdims() - 1;
+    auto width    = w.out_lens.back();
+    // Rows of the same channel write to the same outputs, so only the channels run in parallel
+    par_for(channels, 1, [&](auto c) {
+        std::vector<std::size_t> kidx(w.kdims());
+        T* out = output + c * out_size;
+        for(std::size_t k = 0; k < ksize; k++)
+        {
+            w.kernel_index(k, kidx);
+            const T* in = col + (c * ksize + k) * cols;
+            w.for_each_row(kidx, [&](auto r, auto offset, auto valid) {
+                if(not valid)
+                    return;
+                const T* in_row = in + r * width;
+                for(std::size_t x = 0; x < width; x++)
+                {
+                    auto i = w.input_pos(last, x, kidx[last]);
+                    if(w.in_range(last, i))
+                        out[offset + i] += in_row[x];
+                }
+            });
+        }
+    });
+}
+
+// Computes c[i][j] = sum(a(i, l) * b[l][j]) where a(i, l) is a[i * a_stride_m + l * a_stride_k].
+// The loops are blocked so a tile of b stays in cache, and the inner loop runs over contiguous
+// memory so it can be vectorized.
+template <class T>
+void conv_gemm(T* c,
+               const T* a,
+               std::size_t a_stride_m,
+               std::size_t a_stride_k,
+               const T* b,
+               std::size_t m,
+               std::size_t k,
+               std::size_t n)
+{
+    const std::size_t block_k = 64;
+    const std::size_t block_n = 256;
+    par_for(m, 1, [&](auto i) {
+        T* c_row = c + i * n;
+        std::fill(c_row, c_row + n, T{0});
+        for(std::size_t j0 = 0; j0 < n; j0 += block_n)
+        {
+            auto j1 = std::min(n, j0 + block_n);
+            for(std::size_t l0 = 0; l0 < k; l0 += block_k)
+            {
+                auto l1 = std::min(k, l0 + block_k);
+                for(std::size_t l = l0; l < l1; l++)
+                {
+                    const T x      = a[i * a_stride_m + l * a_stride_k];
+                    const T* b_row = b + l * n;
+                    for(std::size_t j = j0; j < j1; j++)
+                        c_row[j] += x * b_row[j];
+                }
+            }
+        }
+    });
+}
+
+template <class U, class T>
+std::vector<U> convert_to_vector(const T& x)
+{
+    std::vector<U> result(x.size());
+    std::transform(x.begin(), x.end(), result.begin(), [](auto v) { return U(v); });
+    return result;
+}
+
 template <class Op>
 struct ref_convolution : auto_register_op<ref_convolution<Op>>
 {
@@ -155,6 +352,60 @@ struct ref_convolution : auto_register_op<ref_convolution<Op>>
         return op.normalize_compute_shape(inputs);
     }
 
+    // The window loop below is kept for the layouts im2col doesn't handle, which are the ones that
+    // are not standard
+    bool use_im2col(const shape& output_shape, const std::vector<argument>& args) const
+    {
+        return output_shape.standard() and args[0].get_shape().standard() and
+               args[1].get_shape().standard();
+    }
+
+    template <class Output, class Input, class Weights>
+    void compute_im2col(Output output,
+                        Input input,
+                        Weights weights,
+                        const std::vector<std::size_t>& padding) const
+    {
+        using out_type       = typename Output::value_type;
+        using type           = conv_acc_type<out_type>;
+        const auto& in_lens  = input.get_shape().lens();
+        const auto& wei_lens = weights.get_shape().lens();
+        const auto& out_lens = output.get_shape().lens();
+        conv_window w{in_lens, out_lens, wei_lens, op.stride, padding, op.dilation};
+
+        std::size_t groups = op.group;
+        auto channels      = wei_lens[1];
+        auto group_size    = wei_lens[0] / groups;
+        auto ksize         = channels * conv_window::elements(w.kernel);
+        auto cols          = conv_window::elements(w.out_lens);
+        auto in_size       = conv_window::elements(w.in_lens);
+        auto wei           = convert_to_vector<type>(weights);
+        std::vector<type> col(ksize * cols);
+        std::vector<type> out(group_size * cols);
+        for(std::size_t n = 0; n < out_lens[0]; n++)
+        {
+            for(std::size_t g = 0; g < groups; g++)
+            {
+                conv_im2col(col.data(),
+                            input.data() + (n * in_lens[1] + g * channels) * in_size,
+                            channels,
+                            w);
+                conv_gemm(out.data(),
+                          wei.data() + g * group_size * ksize,
+                          ksize,
+                          1,
+                          col.data(),
+                          group_size,
+                          ksize,
+                          cols);
+                std::transform(out.begin(),
+                               out.end(),
+                               output.data() + (n * out_lens[1] + g * group_size) * cols,
+                               [](auto x) { return out_type(x); });
+            }
+        }
+    }
+
     argument compute(context&, shape output_shape, std::vector<argument> args) const
     {
         std::vector<std::size_t> padding;
@@ -181,6 +432,11 @@ struct ref_convolution : auto_register_op<ref_convolution<Op>>
 
         argument result{output_shape};
         visit_quantize(result, args[0], args[1])([&](auto output, auto input, auto weights) {
+            if(use_im2col(output_shape, args))
+            {
+                compute_im2col(output, input, weights, padding);
+                return;
+            }
             auto in_lens = input.get_shape().lens();
 
             auto wei_lens = weights.get_shape().lens();
@@ -210,11 +466,8 @@ struct ref_convolution : auto_register_op<ref_convolution<Op>>
                     const auto in_ch = group_id * wei_c + k;
                     std::vector<std::ptrdiff_t> idx(idx_o.begin(), idx_o.end());
                     idx[1] = in_ch;
-                    std::transform(idx_win.begin() + 1,
-                                   idx_win.end(),
-                                   win_start.begin(),
-                                   idx.begin() + 2,
-                                   [](std::ptrdiff_t ii, std::ptrdiff_t jj) { return ii + jj; });
+                    for(std::size_t d = 0; d < win_start.size(); d++)
+                        idx[d + 2] = std::ptrdiff_t(idx_win[d + 1] * op.dilation[d]) + win_start[d];
                     std::vector<std::ptrdiff_t> idx_wei(idx_o.size());
                     idx_wei[0] = w;
                     std::copy(idx_win.begin(), idx_win.end(), idx_wei.begin() + 1);
@@ -237,6 +490,68 @@ struct ref_convolution : auto_register_op<ref_convolution<Op>>
     }
 };
 
+struct ref_deconvolution
+{
+    op::deconvolution op;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::reflect(self.op, f);
+    }
+
+    std::string name() const { return "ref::deconvolution"; }
+    shape compute_shape(const std::vector<shape>& inputs) const { return op.compute_shape(inputs); }
+    argument compute(context&, const shape& output_shape, std::vector<argument> args) const
+    {
+        // Grouped and non-packed deconvolutions use the reference implementation of the operator
+        if(op.group != 1 or not output_shape.standard() or not args[0].get_shape().standard() or
+           not args[1].get_shape().standard())
+            return op.compute(output_shape, args);
+
+        argument result{output_shape};
+        visit_all(result, args[0], args[1])([&](auto output, auto input, auto weights) {
+            using out_type       = typename decltype(output)::value_type;
+            using type           = conv_acc_type<out_type>;
+            const auto& in_lens  = input.get_shape().lens();
+            const auto& wei_lens = weights.get_shape().lens();
+            const auto& out_lens = output_shape.lens();
+            // The output of the transposed convolution is the side of the window gathered by
+            // im2col
+            conv_window w{out_lens, in_lens, wei_lens, op.stride, op.padding, op.dilation};
+
+            auto in_channels  = in_lens[1];
+            auto out_channels = wei_lens[1];
+            auto ksize        = out_channels * conv_window::elements(w.kernel);
+            auto cols         = conv_window::elements(w.out_lens);
+            auto out_size     = conv_window::elements(w.in_lens);
+            auto wei          = convert_to_vector<type>(weights);
+            auto x            = convert_to_vector<type>(input);
+            std::vector<type> col(ksize * cols);
+            std::vector<type> out(out_channels * out_size);
+            for(std::size_t n = 0; n < in_lens[0]; n++)
+            {
+                conv_gemm(col.data(),
+                          wei.data(),
+                          1,
+                          ksize,
+                          x.data() + n * in_channels * cols,
+                          ksize,
+                          in_channels,
+                          cols);
+                std::fill(out.begin(), out.end(), type{0});
+                conv_col2im(out.data(), col.data(), out_channels, w);
+                std::transform(out.begin(),
+                               out.end(),
+                               output.data() + n * out.size(),
+                               [](auto y) { return out_type(y); });
+            }
+        });
+        return result;
+    }
+};
+MIGRAPHX_REGISTER_OP(ref_deconvolution)
+
 struct ref_im2col
 {
     op::im2col op;
@@ -354,17 +669,18 @@ struct ref_pad
         argument result{output_shape};
         result.visit([&](auto output) {
             using type = typename decltype(output)::value_type;
-            std::fill(output.begin(), output.end(), pad_clamp<type>(op.value));
+            std::fill(output.data(), output.data() + output.size(), pad_clamp<type>(op.value));
         });
 
         visit_all(result, args[0])([&](auto output, auto input) {
-            shape_for_each(input.get_shape(), [&](const auto& idx) {
-                std::vector<std::size_t> new_idx(idx.size());
-                std::transform(
-                    idx.begin(), idx.end(), op.pads.begin(), new_idx.begin(), [](auto i, auto j) {
-                        return i + j;
-                    });
-                output(new_idx.begin(), new_idx.end()) = input(idx.begin(), idx.end());
+            // Copy the input to the view of the output without the padding
+            const auto& lens = input.get_shape().lens();
+            std::vector<std::size_t> starts(op.pads.begin(), op.pads.begin() + lens.size());
+            auto* slice                 = output.data() + output_shape.index(starts);
+            std::array<shape, 2> shapes = {shape{output_shape.type(), lens, output_shape.strides()},
+                                           input.get_shape()};
+            shape_for_each_offset(shapes, [&](const auto& offsets) {
+                slice[offsets[0]] = input.data()[offsets[1]];
             });
         });
 
@@ -625,9 +941,10 @@ struct ref_apply
 
     void init()
     {
-        apply_map["convolution"] = extend_op<ref_convolution<op::convolution>, op::convolution>();
-        apply_map["dot"]         = extend_op<ref_gemm, op::dot>();
-        apply_map["quant_dot"]   = extend_op<ref_quant_gemm, op::quant_dot>();
+        apply_map["convolution"]   = extend_op<ref_convolution<op::convolution>, op::convolution>();
+        apply_map["deconvolution"] = extend_op<ref_deconvolution, op::deconvolution>();
+        apply_map["dot"]           = extend_op<ref_gemm, op::dot>();
+        apply_map["quant_dot"]     = extend_op<ref_quant_gemm, op::quant_dot>();
         apply_map["quant_convolution"] =
             extend_op<ref_convolution<op::quant_convolution>, op::quant_convolution>();
         apply_map["elu"]        = extend_op<ref_unary<elu_op>, op::elu>();
@@ -33,6 +33,8 @@
 #include <migraphx/dead_code_elimination.hpp>
 #include <migraphx/generate.hpp>
 #include <migraphx/normalize_ops.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/module.hpp>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
@@ -57,6 +59,16 @@ std::vector<pass> target::get_passes(migraphx::context&, const compile_options&)
 
 argument target::allocate(const shape& s) const { return fill_argument(s, 0); }
 
+supported_segments target::find_supported(const_module_ref mod, support_metric) const
+{
+    // Every operator has a reference implementation, but it is the slowest choice
+    supported_segment instrs;
+    for(const auto ins : iterator_for(*mod))
+        instrs.instructions.insert(ins);
+    instrs.metric = 10;
+    return {instrs};
+}
+
 MIGRAPHX_REGISTER_TARGET(target);
 
 } // namespace ref
@@ -28,20 +28,25 @@
 #include <migraphx/stringutils.hpp>
 #include <migraphx/value.hpp>
 #include <migraphx/optional.hpp>
+#include <cstring>
+#include <mutex>
 #include <unordered_map>
 #include <utility>
 
 namespace migraphx {
 inline namespace MIGRAPHX_INLINE_NS {
 
+struct object_value_holder;
+
 struct value_base_impl : cloneable<value_base_impl>
 {
     virtual value::type_t get_type() { return value::null_type; }
 #define MIGRAPHX_VALUE_GENERATE_BASE_FUNCTIONS(vt, cpp_type) \
     virtual const cpp_type* if_##vt() const { return nullptr; }
     MIGRAPHX_VISIT_VALUE_TYPES(MIGRAPHX_VALUE_GENERATE_BASE_FUNCTIONS)
+    virtual const value::binary_view* if_binary_view() const { return nullptr; }
     virtual std::vector<value>* if_array() { return nullptr; }
-    virtual std::unordered_map<std::string, std::size_t>* if_object() { return nullptr; }
+    virtual object_value_holder* if_object() { return nullptr; }
     virtual value_base_impl* if_value() const { return nullptr; }
     value_base_impl()                       = default;
     value_base_impl(const value_base_impl&) = default;
@@ -59,6 +64,22 @@ struct value_base_impl : cloneable<value_base_impl>
     };
 MIGRAPHX_VISIT_VALUE_TYPES(MIGRAPHX_VALUE_GENERATE_BASE_TYPE)
 
+// The bytes are only copied into a binary when something asks for one
+struct binary_view_holder : value_base_impl::share
+{
+    binary_view_holder(value::binary_view v) : view(std::move(v)) {}
+    virtual value::type_t get_type() override { return value::binary_type; }
+    virtual const value::binary* if_binary() const override
+    {
+        std::call_once(copied, [&] { data = value::binary{view.data, view.size}; });
+        return &data;
+    }
+    virtual const value::binary_view* if_binary_view() const override { return &view; }
+    value::binary_view view;
+    mutable std::once_flag copied;
+    mutable value::binary data;
+};
+
 struct array_value_holder : value_base_impl::derive<array_value_holder>
 {
     array_value_holder() {}
@@ -68,29 +89,149 @@ struct array_value_holder : value_base_impl::derive<array_value_holder>
     std::vector<value> data;
 };
 
+// Small objects are searched linearly over their elements, only larger objects keep a hash index
 struct object_value_holder : value_base_impl::derive<object_value_holder>
 {
+    static constexpr std::size_t small_object_size = 16;
+
     object_value_holder() {}
-    object_value_holder(std::vector<value> d, std::unordered_map<std::string, std::size_t> l)
-        : data(std::move(d)), lookup(std::move(l))
+    object_value_holder(std::vector<value> d) : data(std::move(d))
     {
+        if(data.size() > small_object_size)
+            build_lookup();
     }
     virtual value::type_t get_type() override { return value::object_type; }
     virtual std::vector<value>* if_array() override { return &data; }
-    virtual std::unordered_map<std::string, std::size_t>* if_object() override { return &lookup; }
+    virtual object_value_holder* if_object() override { return this; }
+
+    // Returns the index of the key, or the size when it is not found. Duplicated keys resolve to
+    // the last element.
+    std::size_t find(const std::string& key) const
+    {
+        if(lookup.empty())
+        {
+            auto it = std::find_if(data.rbegin(), data.rend(), [&](const value& v) {
+                return v.get_key() == key;
+            });
+            return it == data.rend() ? data.size() : data.rend() - it - 1;
+        }
+        auto it = lookup.find(key);
+        if(it == lookup.end())
+            return data.size();
+        return it->second;
+    }
+
+    std::pair<std::size_t, bool> insert(const value& v)
+    {
+        auto i = find(v.get_key());
+        if(i != data.size())
+            return std::make_pair(i, false);
+        data.push_back(v);
+        if(not lookup.empty())
+            lookup.emplace(v.get_key(), i);
+        else if(data.size() > small_object_size)
+            build_lookup();
+        return std::make_pair(i, true);
+    }
+
+    void clear()
+    {
+        data.clear();
+        lookup.clear();
+    }
+
+    void build_lookup()
+    {
+        lookup.clear();
+        lookup.reserve(data.size());
+        for(std::size_t i = 0; i < data.size(); i++)
+            lookup[data[i].get_key()] = i;
+    }
+
     std::vector<value> data;
     std::unordered_map<std::string, std::size_t> lookup;
 };
 
-value::value(const value& rhs) : x(rhs.x ? rhs.x->clone() : nullptr), key(rhs.key) {}
+template <class T>
+bool is_inline(const T&)
+{
+    return std::is_arithmetic<T>{};
+}
+
+// Short strings fit in the small string buffer, so storing them inline never allocates. Longer
+// strings stay in a holder that copies of the value share.
+bool is_inline(const std::string& s) { return s.size() < sizeof(std::string) / 2; }
+
+template <class Holder, class T>
+void value::set_scalar(type_t t, T i)
+{
+    destroy_inline();
+    if(is_inline(i))
+    {
+        new(storage) T(std::move(i));
+        inline_type = t;
+        x           = nullptr;
+    }
+    else
+    {
+        x = std::make_shared<Holder>(std::move(i));
+    }
+}
+
+void value::copy_inline(const value& rhs)
+{
+    if(rhs.inline_type == string_type)
+        new(storage) std::string(*rhs.inline_data<std::string>());
+    else
+        std::memcpy(storage, rhs.storage, sizeof(storage));
+    inline_type = rhs.inline_type;
+}
+
+void value::move_inline(value& rhs) noexcept
+{
+    if(rhs.inline_type == string_type)
+    {
+        auto* str = std::launder(reinterpret_cast<std::string*>(rhs.storage));
+        new(storage) std::string(std::move(*str));
+    }
+    else
+    {
+        std::memcpy(storage, rhs.storage, sizeof(storage));
+    }
+    inline_type = rhs.inline_type;
+    rhs.destroy_inline();
+}
+
+void value::destroy_inline() noexcept
+{
+    if(inline_type == string_type)
+        std::launder(reinterpret_cast<std::string*>(storage))->~basic_string();
+    inline_type = null_type;
+}
+
+value::value(const value& rhs) : x(rhs.x), key(rhs.key) { copy_inline(rhs); }
+value::value(value&& rhs) noexcept : x(std::move(rhs.x)), key(std::move(rhs.key))
+{
+    move_inline(rhs);
+}
+value::~value() { destroy_inline(); }
 value& value::operator=(value rhs)
 {
     std::swap(rhs.x, x);
+    destroy_inline();
+    move_inline(rhs);
     if(not rhs.key.empty())
         std::swap(rhs.key, key);
     return *this;
 }
 
+// Arrays and objects are shared between copies, so clone them before they are modified
+void mutable_impl(std::shared_ptr<value_base_impl>& x)
+{
+    if(x != nullptr and x.use_count() > 1 and x->if_array() != nullptr)
+        x = x->clone();
+}
+
 void set_vector(std::shared_ptr<value_base_impl>& x,
                 const std::vector<value>& v,
                 bool array_on_empty = true)
@@ -104,29 +245,18 @@ void set_vector(std::shared_ptr<value_base_impl>& x,
         return;
     }
     if(v.front().get_key().empty())
-    {
         x = std::make_shared<array_value_holder>(v);
-    }
     else
-    {
-        std::unordered_map<std::string, std::size_t> lookup;
-        std::size_t i = 0;
-        for(auto&& e : v)
-        {
-            lookup[e.get_key()] = i;
-            i++;
-        }
-        x = std::make_shared<object_value_holder>(v, lookup);
-    }
+        x = std::make_shared<object_value_holder>(v);
 }
 
 value::value(const std::initializer_list<value>& i) : x(nullptr)
 {
     if(i.size() == 2 and i.begin()->is_string() and i.begin()->get_key().empty())
     {
-        key    = i.begin()->get_string();
-        auto r = (i.begin() + 1)->x;
-        x      = r ? r->clone() : nullptr;
+        key = i.begin()->get_string();
+        x   = (i.begin() + 1)->x;
+        copy_inline(*(i.begin() + 1));
         return;
     }
     set_vector(x, std::vector<value>(i.begin(), i.end()));
@@ -157,33 +287,44 @@ value::value(const std::string& pkey, std::nullptr_t) : x(nullptr), key(pkey) {}
 
 value::value(std::nullptr_t) : x(nullptr) {}
 
-value::value(const std::string& pkey, const value& rhs)
-    : x(rhs.x ? rhs.x->clone() : nullptr), key(pkey)
+value::value(const std::string& pkey, const value& rhs) : x(rhs.x), key(pkey)
+{
+    copy_inline(rhs);
+}
+
+value::value(binary_view v) : x(std::make_shared<binary_view_holder>(std::move(v))) {}
+value::value(const std::string& pkey, binary_view v)
+    : x(std::make_shared<binary_view_holder>(std::move(v))), key(pkey)
 {
 }
 
 value::value(const std::string& pkey, const char* i) : value(pkey, std::string(i)) {}
 value::value(const char* i) : value(std::string(i)) {}
 
-#define MIGRAPHX_VALUE_GENERATE_DEFINE_METHODS(vt, cpp_type)                           \
-    value::value(cpp_type i) : x(std::make_shared<vt##_value_holder>(std::move(i))) {} \
-    value::value(const std::string& pkey, cpp_type i)                                  \
-        : x(std::make_shared<vt##_value_holder>(std::move(i))), key(pkey)              \
-    {                                                                                  \
-    }                                                                                  \
-    value& value::operator=(cpp_type rhs)                                              \
-    {                                                                                  \
-        x = std::make_shared<vt##_value_holder>(std::move(rhs));                       \
-        return *this;                                                                  \
-    }                                                                                  \
-    bool value::is_##vt() const { return x ? x->get_type() == vt##_type : false; }     \
-    const cpp_type& value::get_##vt() const                                            \
-    {                                                                                  \
-        auto* r = this->if_##vt();                                                     \
-        assert(r);                                                                     \
-        return *r;                                                                     \
-    }                                                                                  \
-    const cpp_type* value::if_##vt() const { return x ? x->if_##vt() : nullptr; }
+#define MIGRAPHX_VALUE_GENERATE_DEFINE_METHODS(vt, cpp_type)                               \
+    value::value(cpp_type i) { set_scalar<vt##_value_holder>(vt##_type, std::move(i)); } \
+    value::value(const std::string& pkey, cpp_type i) : key(pkey)                          \
+    {                                                                                      \
+        set_scalar<vt##_value_holder>(vt##_type, std::move(i));                            \
+    }                                                                                      \
+    value& value::operator=(cpp_type rhs)                                                  \
+    {                                                                                      \
+        set_scalar<vt##_value_holder>(vt##_type, std::move(rhs));                          \
+        return *this;                                                                      \
+    }                                                                                      \
+    bool value::is_##vt() const { return this->get_type() == vt##_type; }                  \
+    const cpp_type& value::get_##vt() const                                                \
+    {                                                                                      \
+        auto* r = this->if_##vt();                                                         \
+        assert(r);                                                                         \
+        return *r;                                                                         \
+    }                                                                                      \
+    const cpp_type* value::if_##vt() const                                                 \
+    {                                                                                      \
+        if(inline_type == vt##_type)                                                       \
+            return inline_data<cpp_type>();                                                \
+        return x ? x->if_##vt() : nullptr;                                                 \
+    }
 MIGRAPHX_VISIT_VALUE_TYPES(MIGRAPHX_VALUE_GENERATE_DEFINE_METHODS)
 
 value& value::operator=(const char* c)
@@ -194,6 +335,7 @@ value& value::operator=(const char* c)
 
 value& value::operator=(std::nullptr_t)
 {
+    destroy_inline();
     x = nullptr;
     return *this;
 }
@@ -202,6 +344,8 @@ value& value::operator=(const std::initializer_list<value>& i)
 {
     value rhs = i;
     std::swap(rhs.x, x);
+    destroy_inline();
+    move_inline(rhs);
     return *this;
 }
 
@@ -229,7 +373,19 @@ const std::vector<value>* value::if_object() const
     return r;
 }
 
-bool value::is_null() const { return x == nullptr; }
+bool value::is_null() const { return x == nullptr and inline_type == null_type; }
+
+value::binary_view value::get_binary_view() const
+{
+    if(x != nullptr)
+    {
+        if(const auto* view = x->if_binary_view())
+            return *view;
+    }
+    const auto& b = get_binary();
+    // Share the ownership of the holder, so the view outlives this value
+    return {b.data(), b.size(), x};
+}
 
 const std::string& value::get_key() const { return key; }
 
@@ -261,16 +417,20 @@ T* find_impl(const std::shared_ptr<value_base_impl>& x, const std::string& key,
     auto* a = if_array_impl(x);
     if(a == nullptr)
         return end;
-    auto* lookup = x->if_object();
-    if(lookup == nullptr)
+    auto* obj = x->if_object();
+    if(obj == nullptr)
         return end;
-    auto it = lookup->find(key);
-    if(it == lookup->end())
+    auto i = obj->find(key);
+    if(i == a->size())
         return end;
-    return std::addressof((*a)[it->second]);
+    return std::addressof((*a)[i]);
 }
 
-value* value::find(const std::string& pkey) { return find_impl(x, pkey, this->end()); }
+value* value::find(const std::string& pkey)
+{
+    mutable_impl(x);
+    return find_impl(x, pkey, this->end());
+}
 
 const value* value::find(const std::string& pkey) const { return find_impl(x, pkey, this->end()); }
 bool value::contains(const std::string& pkey) const
@@ -299,6 +459,7 @@ const value* value::data() const
 }
 value* value::data()
 {
+    mutable_impl(x);
     auto* a = if_array_impl(x);
     if(a == nullptr)
         return nullptr;
@@ -340,6 +501,7 @@ const value& value::back() const
 }
 value& value::at(std::size_t i)
 {
+    mutable_impl(x);
     auto* a = if_array_impl(x);
     if(a == nullptr)
         MIGRAPHX_THROW("Not an array");
@@ -382,48 +544,70 @@ const value& value::operator[](std::size_t i) const
 }
 value& value::operator[](const std::string& pkey) { return *emplace(pkey, nullptr).first; }
 
-void value::clear() { get_array_throw(x).clear(); }
+void value::clear()
+{
+    get_array_throw(x);
+    // Start from an empty holder rather than copying the shared elements
+    if(x.use_count() > 1)
+        set_vector(x, {}, is_array());
+    else if(auto* obj = x->if_object())
+        obj->clear();
+    else
+        get_array_impl(x).clear();
+}
 void value::resize(std::size_t n)
 {
     if(not is_array())
         MIGRAPHX_THROW("Expected an array.");
+    mutable_impl(x);
     get_array_impl(x).resize(n);
 }
 void value::resize(std::size_t n, const value& v)
 {
     if(not is_array())
         MIGRAPHX_THROW("Expected an array.");
-    get_array_impl(x).resize(n, v);
+    // Copy first since v could be an element of this array
+    value e = v;
+    mutable_impl(x);
+    get_array_impl(x).resize(n, e);
 }
 
 std::pair<value*, bool> value::insert(const value& v)
 {
-    if(v.key.empty())
+    // Copy first since v could share its storage with this value
+    value e = v;
+    if(e.key.empty())
     {
-        if(not x)
+        if(is_null())
             x = std::make_shared<array_value_holder>();
-        get_array_impl(x).push_back(v);
+        mutable_impl(x);
+        get_array_impl(x).push_back(std::move(e));
         assert(this->if_array());
         return std::make_pair(&back(), true);
     }
     else
     {
-        if(not x)
+        if(is_null() or (is_array() and empty()))
             x = std::make_shared<object_value_holder>();
-        auto p = x->if_object()->emplace(v.key, get_array_impl(x).size());
-        if(p.second)
-            get_array_impl(x).push_back(v);
+        mutable_impl(x);
+        auto* obj = x ? x->if_object() : nullptr;
+        if(obj == nullptr)
+            MIGRAPHX_THROW("Expected an object");
+        auto p = obj->insert(e);
         assert(this->if_object());
-        return std::make_pair(&get_array_impl(x)[p.first->second], p.second);
+        return std::make_pair(&obj->data[p.first], p.second);
     }
 }
 value* value::insert(const value* pos, const value& v)
 {
     assert(v.key.empty());
-    if(not x)
+    auto offset = pos - std::as_const(*this).begin();
+    value e     = v;
+    if(is_null())
         x = std::make_shared<array_value_holder>();
+    mutable_impl(x);
     auto&& a = get_array_impl(x);
-    auto it  = a.insert(a.begin() + (pos - begin()), v);
+    auto it  = a.insert(a.begin() + offset, std::move(e));
     return std::addressof(*it);
 }
 
@@ -466,6 +650,8 @@ bool compare(const value& x, const value& y, F f)
 
 value::type_t value::get_type() const
 {
+    if(inline_type != null_type)
+        return inline_type;
     if(not x)
         return null_type;
     return x->get_type();
@@ -0,0 +1,91 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef MIGRAPHX_GUARD_TEST_BENCH_BENCH_HPP
+#define MIGRAPHX_GUARD_TEST_BENCH_BENCH_HPP
+
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/ref/target.hpp>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace bench {
+
+template <class F>
+double time_ms(F f, std::size_t iterations = 10)
+{
+    // Warm up
+    f();
+    auto start = std::chrono::steady_clock::now();
+    for(std::size_t i = 0; i < iterations; i++)
+        f();
+    auto finish = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(finish - start).count() / iterations;
+}
+
+inline void print_header()
+{
+    std::cout << std::left << std::setw(40) << "Benchmark" << std::right << std::setw(14)
+              << "Elements" << std::setw(12) << "Time (ms)" << std::setw(12) << "GB/s"
+              << std::endl;
+}
+
+inline void print(const std::string& name, std::size_t elements, std::size_t bytes, double ms)
+{
+    std::cout << std::left << std::setw(40) << name << std::right << std::setw(14) << elements
+              << std::setw(12) << std::fixed << std::setprecision(3) << ms << std::setw(12)
+              << std::setprecision(2) << (bytes / ms / 1.0e6) << std::endl;
+}
+
+// Columns for benchmarks that are not bound by memory bandwidth, such as compiler passes
+inline void print_header(const std::string& count)
+{
+    std::cout << std::left << std::setw(40) << "Benchmark" << std::right << std::setw(14) << count
+              << std::setw(12) << "Time (ms)" << std::endl;
+}
+
+inline void print(const std::string& name, std::size_t count, double ms)
+{
+    std::cout << std::left << std::setw(40) << name << std::right << std::setw(14) << count
+              << std::setw(12) << std::fixed << std::setprecision(3) << ms << std::endl;
+}
+
+// Compiles the program for ref and reports the bandwidth from the size of the output, which is
+// read and written once
+inline void run_ref(const std::string& name, migraphx::program p)
+{
+    p.compile(migraphx::ref::target{});
+    migraphx::parameter_map params;
+    for(auto&& x : p.get_parameter_shapes())
+        params[x.first] = migraphx::generate_argument(x.second);
+    auto output = p.get_output_shapes().front();
+    auto ms     = time_ms([&] { p.eval(params); });
+    print(name, output.elements(), 2 * output.bytes(), ms);
+}
+
+} // namespace bench
+
+#endif
@@ -0,0 +1,121 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "bench.hpp"
+#include <migraphx/eliminate_common_subexpression.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/operation.hpp>
+#include <chrono>
+#include <vector>
+
+// Benchmarks common subexpression elimination, which looks up candidates by the operator hash,
+// and the operator hash and attribute reads that passes use instead of serializing the operator
+
+// Slices of one input, each repeated the given number of times
+static migraphx::program make_slices(std::size_t n, std::size_t copies)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {4, 8, 8192}});
+    std::vector<migraphx::instruction_ref> outputs;
+    for(std::size_t i = 0; i < n; i++)
+    {
+        for(std::size_t j = 0; j < copies; j++)
+        {
+            outputs.push_back(mm->add_instruction(
+                migraphx::make_op("slice", {{"axes", {2}}, {"starts", {i}}, {"ends", {8192}}}),
+                x));
+        }
+    }
+    mm->add_return(outputs);
+    return p;
+}
+
+// A chain of the same unary ops on two inputs, which differ only in their inputs
+static migraphx::program make_chains(std::size_t n)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {64}};
+    auto x = mm->add_parameter("x", s);
+    auto y = mm->add_parameter("y", s);
+    for(std::size_t i = 0; i < n; i++)
+    {
+        auto name = i % 2 == 0 ? "exp" : "neg";
+        x         = mm->add_instruction(migraphx::make_op(name), x);
+        y         = mm->add_instruction(migraphx::make_op(name), y);
+    }
+    mm->add_return({x, y});
+    return p;
+}
+
+// Times the pass on fresh copies of the program, leaving out the copy
+static double time_cse(const migraphx::program& p, std::size_t iterations = 10)
+{
+    std::chrono::duration<double, std::milli> total{0};
+    for(std::size_t i = 0; i < iterations + 1; i++)
+    {
+        auto q     = p;
+        auto start = std::chrono::steady_clock::now();
+        migraphx::eliminate_common_subexpression{}.apply(*q.get_main_module());
+        // The first run warms up
+        if(i > 0)
+            total += std::chrono::steady_clock::now() - start;
+    }
+    return total.count() / iterations;
+}
+
+int main()
+{
+    bench::print_header("Instructions");
+    for(auto&& [name, p] : {std::make_pair("cse distinct slices", make_slices(4000, 1)),
+                            std::make_pair("cse repeated slices", make_slices(1000, 4)),
+                            std::make_pair("cse unary chains", make_chains(2000))})
+        bench::print(name, p.get_main_module()->size(), time_cse(p));
+
+    const std::size_t calls = 100000;
+    auto op = migraphx::make_op("slice", {{"axes", {2}}, {"starts", {1}}, {"ends", {16}}});
+    std::size_t total = 0;
+    std::cout << std::endl;
+    bench::print_header("Calls");
+    bench::print("operation::hash",
+                 calls,
+                 bench::time_ms([&] {
+                     for(std::size_t i = 0; i < calls; i++)
+                         total += op.hash();
+                 }));
+    bench::print("operation::to_value",
+                 calls,
+                 bench::time_ms([&] {
+                     for(std::size_t i = 0; i < calls; i++)
+                         total += op.to_value().size();
+                 }));
+    bench::print("operation::field",
+                 calls,
+                 bench::time_ms([&] {
+                     for(std::size_t i = 0; i < calls; i++)
+                         total += op.field("starts").size();
+                 }));
+    return total == 0 ? 1 : 0;
+}
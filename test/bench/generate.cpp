@@ -0,0 +1,43 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "bench.hpp"
+#include <migraphx/generate.hpp>
+
+// Benchmarks the generation of random and filled arguments of the types used for inputs
+int main()
+{
+    const std::vector<std::size_t> lens = {64, 1024, 1024};
+    bench::print_header();
+    for(auto t : {migraphx::shape::float_type,
+                  migraphx::shape::half_type,
+                  migraphx::shape::int8_type,
+                  migraphx::shape::int32_type})
+    {
+        migraphx::shape s{t, lens};
+        auto generate = bench::time_ms([&] { migraphx::generate_argument(s, 1); }, 3);
+        bench::print("generate_argument " + s.type_string(), s.elements(), s.bytes(), generate);
+        auto fill = bench::time_ms([&] { migraphx::fill_argument(s, 1); }, 3);
+        bench::print("fill_argument " + s.type_string(), s.elements(), s.bytes(), fill);
+    }
+}
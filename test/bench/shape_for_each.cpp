@@ -0,0 +1,101 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "bench.hpp"
+#include <migraphx/instruction.hpp>
+#include <migraphx/make_op.hpp>
+#include <functional>
+#include <vector>
+
+// Benchmarks the ops that iterate over tensors with transposed, broadcasted and sliced layouts
+using layout_function =
+    std::function<migraphx::instruction_ref(migraphx::module&, const std::vector<std::size_t>&)>;
+
+static std::vector<std::pair<std::string, layout_function>> layouts()
+{
+    return {{"standard",
+             [](migraphx::module& m, const std::vector<std::size_t>& lens) {
+                 return m.add_parameter("x", {migraphx::shape::float_type, lens});
+             }},
+            {"transposed",
+             [](migraphx::module& m, const std::vector<std::size_t>& lens) {
+                 auto x = m.add_parameter(
+                     "x", {migraphx::shape::float_type, {lens[0], lens[2], lens[3], lens[1]}});
+                 return m.add_instruction(
+                     migraphx::make_op("transpose", {{"permutation", {0, 3, 1, 2}}}), x);
+             }},
+            {"broadcast",
+             [](migraphx::module& m, const std::vector<std::size_t>& lens) {
+                 auto x = m.add_parameter("x", {migraphx::shape::float_type, {lens[1]}});
+                 return m.add_instruction(
+                     migraphx::make_op("broadcast", {{"axis", 1}, {"out_lens", lens}}), x);
+             }},
+            {"sliced", [](migraphx::module& m, const std::vector<std::size_t>& lens) {
+                 auto x = m.add_parameter(
+                     "x", {migraphx::shape::float_type, {lens[0], lens[1], lens[2], lens[3] + 8}});
+                 return m.add_instruction(
+                     migraphx::make_op("slice", {{"axes", {3}}, {"starts", {4}}, {"ends", {60}}}),
+                     x);
+             }}};
+}
+
+using op_function = std::function<void(migraphx::module&, migraphx::instruction_ref)>;
+
+static std::vector<std::pair<std::string, op_function>> ops()
+{
+    return {{"contiguous",
+             [](migraphx::module& m, migraphx::instruction_ref x) {
+                 m.add_instruction(migraphx::make_op("contiguous"), x);
+             }},
+            {"gather",
+             [](migraphx::module& m, migraphx::instruction_ref x) {
+                 std::vector<std::int32_t> indices = {3, 1, 4, 1, 5, 9, 2, 6};
+                 auto i = m.add_literal(migraphx::literal{
+                     {migraphx::shape::int32_type, {indices.size()}}, indices});
+                 m.add_instruction(migraphx::make_op("gather", {{"axis", 1}}), x, i);
+             }},
+            {"concat",
+             [](migraphx::module& m, migraphx::instruction_ref x) {
+                 m.add_instruction(migraphx::make_op("concat", {{"axis", 1}}), x, x);
+             }},
+            {"pad", [](migraphx::module& m, migraphx::instruction_ref x) {
+                 m.add_instruction(migraphx::make_op("pad", {{"pads", {0, 0, 1, 1, 0, 0, 1, 1}}}),
+                                   x);
+             }}};
+}
+
+int main()
+{
+    const std::vector<std::size_t> lens = {8, 64, 56, 56};
+    bench::print_header();
+    for(auto&& op : ops())
+    {
+        for(auto&& layout : layouts())
+        {
+            migraphx::program p;
+            auto* mm = p.get_main_module();
+            op.second(*mm, layout.second(*mm, lens));
+            bench::run_ref(op.first + " " + layout.first, p);
+        }
+    }
+}
@@ -0,0 +1,103 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "bench.hpp"
+#include <migraphx/make_op.hpp>
+#include <migraphx/literal.hpp>
+#include <migraphx/value.hpp>
+#include <string>
+#include <vector>
+
+// Benchmarks converting a program to and from a value, and building the small values that
+// operators and shapes are made of
+
+// A chain of adds with a 64KB literal each, followed by a relu
+static migraphx::program make_program(std::size_t n)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {64, 256}};
+    auto x = mm->add_parameter("x", s);
+    std::vector<float> data(s.elements(), 1.0f);
+    for(std::size_t i = 0; i < n; i++)
+    {
+        auto l = mm->add_literal(migraphx::literal{s, data});
+        x      = mm->add_instruction(migraphx::make_op("add"), x, l);
+        x      = mm->add_instruction(migraphx::make_op("relu"), x);
+    }
+    mm->add_return({x});
+    return p;
+}
+
+int main()
+{
+    auto p            = make_program(2000);
+    auto instructions = p.get_main_module()->size();
+    auto v            = p.to_value();
+    std::size_t total = 0;
+    bench::print_header("Count");
+    bench::print("program::to_value",
+                 instructions,
+                 bench::time_ms([&] { total += p.to_value().size(); }, 3));
+    bench::print("program::from_value",
+                 instructions,
+                 bench::time_ms(
+                     [&] {
+                         migraphx::program q;
+                         q.from_value(v);
+                         total += q.get_main_module()->size();
+                     },
+                     3));
+    bench::print("read node operators",
+                 instructions,
+                 bench::time_ms([&] {
+                     for(const auto& node : v.at("modules").at("main").at("nodes"))
+                         total += node.at("operator").size();
+                 }));
+
+    const std::size_t n = 100000;
+    bench::print("array of 8 integers",
+                 n,
+                 bench::time_ms([&] {
+                     for(std::size_t i = 0; i < n; i++)
+                         total += migraphx::value{1, 2, 3, 4, 5, 6, 7, i}.size();
+                 }));
+    bench::print("object of short strings",
+                 n,
+                 bench::time_ms([&] {
+                     for(std::size_t i = 0; i < n; i++)
+                     {
+                         migraphx::value x = {{"name", "relu"}, {"type", "float"}, {"axis", i}};
+                         total += x.size();
+                     }
+                 }));
+    bench::print("operation::to_value",
+                 n,
+                 bench::time_ms([&] {
+                     auto op = migraphx::make_op(
+                         "slice", {{"axes", {2}}, {"starts", {1}}, {"ends", {16}}});
+                     for(std::size_t i = 0; i < n; i++)
+                         total += op.to_value().size();
+                 }));
+    return total == 0 ? 1 : 0;
+}
@@ -0,0 +1,100 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/compile_cache.hpp>
+#include <migraphx/compile_src.hpp>
+#include <migraphx/tmp_dir.hpp>
+#include <test.hpp>
+
+std::vector<char> make_data(const std::string& s) { return {s.begin(), s.end()}; }
+
+TEST_CASE(cache_store_lookup)
+{
+    migraphx::tmp_dir td{"cache"};
+    migraphx::compile_cache c{td.path, 1024};
+    EXPECT(not c.lookup("abc").has_value());
+    c.store("abc", make_data("hello"));
+    auto result = c.lookup("abc");
+    EXPECT(result.has_value());
+    EXPECT(*result == make_data("hello"));
+    EXPECT(c.hits.load() == 1);
+    EXPECT(c.misses.load() == 1);
+    EXPECT(c.size() == 5);
+}
+
+TEST_CASE(cache_shared_dir)
+{
+    migraphx::tmp_dir td{"cache"};
+    migraphx::compile_cache c1{td.path, 1024};
+    migraphx::compile_cache c2{td.path, 1024};
+    c1.store("abc", make_data("hello"));
+    c2.store("abc", make_data("hello"));
+    EXPECT(*c2.lookup("abc") == make_data("hello"));
+    EXPECT(c1.size() == 5);
+}
+
+TEST_CASE(cache_evict_lru)
+{
+    migraphx::tmp_dir td{"cache"};
+    migraphx::compile_cache c{td.path, 10};
+    auto now = migraphx::fs::file_time_type::clock::now();
+    c.store("a", make_data("1234"));
+    migraphx::fs::last_write_time(c.path("a"), now - std::chrono::hours{2});
+    c.store("b", make_data("1234"));
+    migraphx::fs::last_write_time(c.path("b"), now - std::chrono::hours{1});
+    // Using an entry makes it the most recently used
+    EXPECT(c.lookup("a").has_value());
+    c.store("c", make_data("1234"));
+    EXPECT(c.size() <= 10);
+    EXPECT(c.lookup("a").has_value());
+    EXPECT(not c.lookup("b").has_value());
+    EXPECT(c.lookup("c").has_value());
+}
+
+TEST_CASE(cache_key_builder)
+{
+    auto k1 = migraphx::cache_key_builder{}.add("ab").add("c").str();
+    auto k2 = migraphx::cache_key_builder{}.add("a").add("bc").str();
+    auto k3 = migraphx::cache_key_builder{}.add("ab").add("c").str();
+    EXPECT(k1 != k2);
+    EXPECT(k1 == k3);
+    EXPECT(k1.size() == 32);
+}
+
+TEST_CASE(src_compiler_key)
+{
+    const std::string src1 = "int f() { return 1; }";
+    const std::string src2 = "int f() { return 2; }";
+    migraphx::src_file f1{"main.cpp", std::make_pair(src1.data(), src1.data() + src1.size())};
+    migraphx::src_file f2{"main.cpp", std::make_pair(src2.data(), src2.data() + src2.size())};
+    migraphx::src_compiler compiler;
+    compiler.flags = "-c";
+    auto key       = compiler.cache_key({f1});
+    EXPECT(key == compiler.cache_key({f1}));
+    EXPECT(key != compiler.cache_key({f2}));
+    auto other  = compiler;
+    other.flags = "-c -O2";
+    EXPECT(key != other.cache_key({f1}));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -171,6 +171,34 @@ TEST_CASE(cse_test_literal)
     EXPECT(m1 == m2);
 }
 
+TEST_CASE(cse_test_attributes)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3, 4}};
+    migraphx::module m1;
+    {
+        auto x  = m1.add_parameter("x", s);
+        auto t1 = m1.add_instruction(
+            migraphx::make_op("transpose", {{"permutation", {1, 0, 2}}}), x);
+        auto t2 = m1.add_instruction(
+            migraphx::make_op("transpose", {{"permutation", {2, 1, 0}}}), x);
+        auto t3 = m1.add_instruction(
+            migraphx::make_op("transpose", {{"permutation", {1, 0, 2}}}), x);
+        m1.add_instruction(pass_op{}, t1, t2, t3);
+    }
+    run_pass(m1);
+
+    migraphx::module m2;
+    {
+        auto x  = m2.add_parameter("x", s);
+        auto t1 = m2.add_instruction(
+            migraphx::make_op("transpose", {{"permutation", {1, 0, 2}}}), x);
+        auto t2 = m2.add_instruction(
+            migraphx::make_op("transpose", {{"permutation", {2, 1, 0}}}), x);
+        m2.add_instruction(pass_op{}, t1, t2, t1);
+    }
+    EXPECT(m1 == m2);
+}
+
 TEST_CASE(cse_test_submodule)
 {
     migraphx::shape si{migraphx::shape::int64_type};
@@ -27,10 +27,39 @@
 #include <migraphx/instruction.hpp>
 #include <migraphx/stringutils.hpp>
 #include <migraphx/compile_options.hpp>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
 #include <sstream>
 #include "test.hpp"
 #include <basic_ops.hpp>
 
+static std::atomic<bool> counting_allocations{false};
+static std::atomic<std::size_t> allocations{0};
+
+void* operator new(std::size_t n)
+{
+    if(counting_allocations)
+        allocations++;
+    if(void* p = std::malloc(n)) // NOLINT
+        return p;
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept { std::free(p); }             // NOLINT
+void operator delete(void* p, std::size_t) noexcept { std::free(p); } // NOLINT
+
+template <class F>
+std::size_t count_allocations(F f)
+{
+    allocations          = 0;
+    counting_allocations = true;
+    f();
+    counting_allocations = false;
+    return allocations;
+}
+
 struct id_target
 {
     struct context
@@ -90,6 +119,57 @@ struct id_ctx_final_op
     int output_alias(const std::vector<migraphx::shape>&) const { return 0; }
 };
 
+struct finalize_order_op
+{
+    int id                                  = 0;
+    bool threadsafe                         = false;
+    std::shared_ptr<std::vector<int>> order = nullptr;
+    int finalized                           = -1;
+
+    template <class Self, class F>
+    static auto reflect(Self& self, F f)
+    {
+        return migraphx::pack(f(self.id, "id"), f(self.threadsafe, "threadsafe"));
+    }
+
+    std::string name() const { return "finalize_order"; }
+    migraphx::value attributes() const { return {{"threadsafe_finalize", threadsafe}}; }
+    migraphx::argument compute(const migraphx::shape&, std::vector<migraphx::argument> args) const
+    {
+        return args.front();
+    }
+
+    void finalize(id_target::context&, const migraphx::shape&, const std::vector<migraphx::shape>&)
+    {
+        finalized = id;
+        if(not threadsafe)
+            order->push_back(id);
+    }
+
+    migraphx::shape compute_shape(std::vector<migraphx::shape> inputs) const
+    {
+        return inputs.front();
+    }
+    int output_alias(const std::vector<migraphx::shape>&) const { return 0; }
+};
+
+struct pass_ref_op
+{
+    std::string name() const { return "pass_ref"; }
+    migraphx::argument compute(migraphx::context&,
+                               const migraphx::shape&,
+                               const std::vector<migraphx::argument>& args) const
+    {
+        return args.front();
+    }
+
+    migraphx::shape compute_shape(std::vector<migraphx::shape> inputs) const
+    {
+        return inputs.front();
+    }
+    int output_alias(const std::vector<migraphx::shape>&) const { return 0; }
+};
+
 struct reverse_pass
 {
     std::string name() const { return "reverse_pass"; }
@@ -498,6 +578,88 @@ TEST_CASE(eval_context3)
     EXPECT(not is_shared(t.ctx, p.get_context()));
 }
 
+TEST_CASE(eval_finalized_allocations)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    auto x   = mm->add_parameter("x", s);
+    auto one = mm->add_literal(migraphx::literal{s, {1, 1, 1, 1}});
+    auto a   = mm->add_instruction(pass_ref_op{}, x, one);
+    auto b   = mm->add_instruction(pass_ref_op{}, one, a);
+    auto c   = mm->add_instruction(pass_ref_op{}, a, b);
+    mm->add_return({c});
+    p.compile(id_target{});
+    EXPECT(mm->get_eval_plan() != nullptr);
+
+    std::vector<float> data = {1, 2, 3, 4};
+    migraphx::parameter_map params{{"x", migraphx::argument{s, data.data()}}};
+    // The first run sizes the buffers that later runs reuse
+    auto result = p.eval(params);
+    EXPECT(result.front().data() == reinterpret_cast<char*>(data.data()));
+    auto n = count_allocations([&] { result = p.eval(std::move(params)); });
+    EXPECT(result.front().data() == reinterpret_cast<char*>(data.data()));
+#ifdef NDEBUG
+    // Only the returned vector is allocated
+    EXPECT(n == 1);
+#else
+    (void)n;
+#endif
+}
+
+TEST_CASE(eval_plan_shares_literals)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    auto one = mm->add_literal(migraphx::literal{s, {1, 1, 1, 1}});
+    auto a   = mm->add_instruction(pass_ref_op{}, one);
+    mm->add_return({a});
+    p.compile(id_target{});
+    EXPECT(mm->get_eval_plan() != nullptr);
+    auto result = p.eval({}).back();
+    EXPECT(result.data() == one->get_literal().data());
+    EXPECT(result == one->get_literal());
+}
+
+TEST_CASE(eval_plan_invalidated)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto one = mm->add_literal(1);
+    auto two = mm->add_literal(2);
+    auto sum = mm->add_instruction(sum_op{}, one, two);
+    p.compile(id_target{});
+    EXPECT(mm->get_eval_plan() != nullptr);
+    EXPECT(p.eval({}).back() == migraphx::literal{3});
+    mm->replace_instruction(sum, minus_op{}, two, one);
+    EXPECT(mm->get_eval_plan() == nullptr);
+    EXPECT(p.eval({}).back() == migraphx::literal{1});
+}
+
+TEST_CASE(finalize_threadsafe)
+{
+    migraphx::program p;
+    auto* mm   = p.get_main_module();
+    auto order = std::make_shared<std::vector<int>>();
+    auto x     = mm->add_literal(1);
+    for(int i = 0; i < 32; i++)
+        x = mm->add_instruction(finalize_order_op{i, i % 3 != 0, order}, x);
+    p.compile(id_target{});
+    int i = 0;
+    for(auto ins : migraphx::iterator_for(*mm))
+    {
+        if(ins->name() != "finalize_order")
+            continue;
+        EXPECT(migraphx::any_cast<finalize_order_op>(ins->get_operator()).finalized == i);
+        i++;
+    }
+    EXPECT(i == 32);
+    // Operators without a thread-safe finalize are still finalized in order
+    EXPECT(*order == std::vector<int>{0, 3, 6, 9, 12, 15, 18, 21, 24, 27, 30});
+    EXPECT(p.eval({}).back() == migraphx::literal{1});
+}
+
 struct cout_redirect
 {
     cout_redirect()                     = delete;
@@ -22,6 +22,7 @@
  * THE SOFTWARE.
  */
 #include <migraphx/generate.hpp>
+#include <algorithm>
 #include "test.hpp"
 
 TEST_CASE(generate)
@@ -61,4 +62,34 @@ TEST_CASE(generate_tuple)
     EXPECT(args.at(2) != migraphx::generate_argument(s2, 0));
 }
 
+TEST_CASE(generate_blocks)
+{
+    // Values only depend on their position, so a larger tensor starts with the smaller one
+    migraphx::shape s1{migraphx::shape::float_type, {70000}};
+    migraphx::shape s2{migraphx::shape::float_type, {3, 65536}};
+    auto arg1 = migraphx::generate_argument(s1, 2);
+    auto arg2 = migraphx::generate_argument(s2, 2);
+    EXPECT(std::equal(arg1.data(), arg1.data() + s1.bytes(), arg2.data()));
+    EXPECT(migraphx::generate_argument(s2, 2) == arg2);
+}
+
+TEST_CASE(generate_seed)
+{
+    migraphx::shape s{migraphx::shape::int32_type, {64}};
+    EXPECT(migraphx::generate_argument(s, 1) != migraphx::generate_argument(s, (1UL << 32U) | 1));
+}
+
+TEST_CASE(generate_range)
+{
+    migraphx::shape sf{migraphx::shape::half_type, {100000}};
+    migraphx::generate_argument(sf, 3).visit([](auto v) {
+        EXPECT(std::all_of(v.begin(), v.end(), [](float x) { return x >= -1 and x < 1; }));
+    });
+    migraphx::shape si{migraphx::shape::int8_type, {100000}};
+    migraphx::generate_argument(si, 3).visit([](auto v) {
+        EXPECT(std::all_of(v.begin(), v.end(), [](int x) { return x > -16 and x <= 16; }));
+        EXPECT(std::any_of(v.begin(), v.end(), [&](int x) { return x != v.front(); }));
+    });
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,99 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/job_server.hpp>
+#include <migraphx/compile_src.hpp>
+#include <migraphx/dynamic_loader.hpp>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <test.hpp>
+
+TEST_CASE(run_all_jobs)
+{
+    std::vector<std::size_t> results(100);
+    std::vector<std::size_t> done;
+    migraphx::job_server js{4};
+    js.progress = [&](std::size_t finished, std::size_t total) {
+        EXPECT(total == results.size());
+        done.push_back(finished);
+    };
+    js.run(results.size(), [&](std::size_t i) { results[i] = i * 2; });
+    for(std::size_t i = 0; i < results.size(); i++)
+        EXPECT(results[i] == i * 2);
+    EXPECT(done.size() == results.size());
+    EXPECT(done.back() == results.size());
+}
+
+TEST_CASE(bounded_workers)
+{
+    std::atomic<std::size_t> running{0};
+    std::atomic<std::size_t> peak{0};
+    migraphx::job_server{2}.run(16, [&](std::size_t) {
+        auto r = ++running;
+        auto p = peak.load();
+        while(r > p and not peak.compare_exchange_weak(p, r))
+            ;
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        running--;
+    });
+    EXPECT(peak.load() <= 2);
+}
+
+TEST_CASE(job_exception)
+{
+    std::atomic<std::size_t> count{0};
+    EXPECT(test::throws([&] {
+        migraphx::job_server{2}.run(100, [&](std::size_t i) {
+            count++;
+            if(i == 3)
+                throw std::runtime_error("failed");
+        });
+    }));
+    EXPECT(count.load() < 100);
+}
+
+TEST_CASE(compile_batch)
+{
+    std::vector<std::string> srcs;
+    std::vector<migraphx::src_compile_job> jobs;
+    for(int i = 0; i < 3; i++)
+        srcs.push_back("extern \"C\" int f(int x) { return x + " + std::to_string(i) + "; }");
+    for(const auto& src : srcs)
+    {
+        migraphx::src_compile_job job;
+        job.compiler.flags  = "-fPIC -shared";
+        job.compiler.output = "libsimple.so";
+        job.srcs            = {{"main.cpp", std::make_pair(src.data(), src.data() + src.size())}};
+        jobs.push_back(job);
+    }
+    auto images = migraphx::compile_all(jobs, migraphx::job_server{2});
+    EXPECT(images.size() == jobs.size());
+    for(int i = 0; i < 3; i++)
+    {
+        auto f = migraphx::dynamic_loader{images[i]}.get_function<int(int)>("f");
+        EXPECT(f(1) == 1 + i);
+    }
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -24,6 +24,7 @@
 
 #include <migraphx/literal.hpp>
 #include <migraphx/serialize.hpp>
+#include <numeric>
 #include <sstream>
 #include <string>
 #include "test.hpp"
@@ -143,6 +144,18 @@ TEST_CASE(literal_visit_empty)
     EXPECT(test::throws([&] { x.visit_at([](auto) {}); }));
 }
 
+TEST_CASE(literal_from_argument)
+{
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    migraphx::argument a{s};
+    a.visit([](auto v) { std::iota(v.begin(), v.end(), 1); });
+    migraphx::literal l{a};
+    EXPECT(l.get_shape() == s);
+    EXPECT(l.data() == a.data());
+    a = {};
+    EXPECT(l == migraphx::literal{s, {1, 2, 3, 4, 5, 6}});
+}
+
 TEST_CASE(value_literal)
 {
     migraphx::shape s{migraphx::shape::int64_type, {3}};
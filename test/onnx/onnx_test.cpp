@@ -1702,6 +1702,19 @@ TEST_CASE(external_data_diff_path_test)
     EXPECT(p == prog);
 }
 
+TEST_CASE(external_data_offset_test)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {4}};
+    auto a = mm->add_literal(migraphx::literal{s, {1, 2, 3, 4}});
+    auto b = mm->add_literal(migraphx::literal{s, {10, 20, 30, 40}});
+    mm->add_instruction(migraphx::make_op("add"), a, b);
+
+    auto prog = optimize_onnx("external_data_offset_test.onnx");
+    EXPECT(p == prog);
+}
+
 TEST_CASE(eyelike_default_test)
 {
     migraphx::program p;
@@ -23,6 +23,7 @@
  */
 
 #include <migraphx/operation.hpp>
+#include <migraphx/make_op.hpp>
 #include <migraphx/context.hpp>
 #include <sstream>
 #include <string>
@@ -254,6 +255,29 @@ TEST_CASE(check_from_value2)
     EXPECT(op1 == op2);
 }
 
+TEST_CASE(check_hash)
+{
+    migraphx::operation op1 = simple_operation{};
+    migraphx::operation op2 = simple_operation{};
+    migraphx::operation op3 = simple_operation{3};
+    migraphx::operation op4 = simple_operation_no_print{};
+
+    EXPECT(op1.hash() == op2.hash());
+    EXPECT(op1.hash() != op3.hash());
+    EXPECT(op1.hash() != op4.hash());
+    EXPECT(migraphx::make_op("transpose", {{"permutation", {1, 0}}}).hash() ==
+           migraphx::make_op("transpose", {{"permutation", {1, 0}}}).hash());
+}
+
+TEST_CASE(check_field)
+{
+    migraphx::operation op = simple_operation{3};
+    EXPECT(op.field("data").to<int>() == 3);
+    EXPECT(op.field("missing").is_null());
+    auto transpose = migraphx::make_op("transpose", {{"permutation", {1, 0}}});
+    EXPECT(transpose.field("permutation").to_vector<int64_t>() == std::vector<int64_t>{1, 0});
+}
+
 TEST_CASE(compile)
 {
     migraphx::operation op = compilable_op{};
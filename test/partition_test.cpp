@@ -0,0 +1,254 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/partition.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/instruction.hpp>
+#include <migraphx/iterator_for.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/eliminate_common_subexpression.hpp>
+#include <migraphx/pass_manager.hpp>
+#include <migraphx/register_target.hpp>
+#include <migraphx/verify.hpp>
+#include <migraphx/ref/target.hpp>
+#include <algorithm>
+#include "test.hpp"
+
+// Runs on the reference implementation, but only supports add and is cheaper than ref for it
+struct add_target : migraphx::ref::target
+{
+    std::string name() const { return "add_ref"; }
+
+    migraphx::supported_segments find_supported(migraphx::const_module_ref mod,
+                                                migraphx::support_metric) const
+    {
+        migraphx::supported_segment segment;
+        for(auto ins : iterator_for(*mod))
+        {
+            if(ins->name() == "add")
+                segment.instructions.insert(ins);
+        }
+        segment.metric = 1;
+        return {segment};
+    }
+};
+
+migraphx::program create_program()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {3}};
+    auto x = mm->add_parameter("x", s);
+    auto y = mm->add_parameter("y", s);
+    auto a = mm->add_instruction(migraphx::make_op("add"), x, y);
+    auto b = mm->add_instruction(migraphx::make_op("mul"), a, y);
+    mm->add_instruction(migraphx::make_op("add"), b, x);
+    return p;
+}
+
+std::size_t count_partitions(const migraphx::program& p)
+{
+    const auto* mm = p.get_main_module();
+    return std::count_if(
+        mm->begin(), mm->end(), [](const auto& ins) { return ins.name() == "run_on_target"; });
+}
+
+std::vector<migraphx::argument> run(migraphx::program p, const migraphx::parameter_map& params)
+{
+    if(not p.is_compiled())
+        p.compile(migraphx::ref::target{});
+    return p.eval(params);
+}
+
+migraphx::parameter_map create_params(const migraphx::program& p)
+{
+    migraphx::parameter_map params;
+    for(auto&& x : p.get_parameter_shapes())
+        params[x.first] = migraphx::generate_argument(x.second, x.first.size());
+    return params;
+}
+
+TEST_CASE(assignments_cost)
+{
+    auto p                 = create_program();
+    const auto assignments = p.get_target_assignments({add_target{}, migraphx::ref::target{}});
+    const auto* mm         = p.get_main_module();
+    EXPECT(mm->size() == assignments.size());
+    for(auto ins : iterator_for(*mm))
+    {
+        if(ins->name() == "add")
+            EXPECT(assignments.at(ins) == "add_ref");
+        else
+            EXPECT(assignments.at(ins) == "ref");
+    }
+}
+
+TEST_CASE(assignments_transfer_cost)
+{
+    auto p = create_program();
+    migraphx::assignment_options options;
+    options.transfer_cost = 1;
+    const auto assignments =
+        p.get_target_assignments({add_target{}, migraphx::ref::target{}}, options);
+    for(auto&& a : assignments)
+        EXPECT(a.second == "ref");
+}
+
+TEST_CASE(partition_targets)
+{
+    auto p      = create_program();
+    auto params = create_params(p);
+    auto gold   = run(p, params);
+
+    migraphx::compile_partitions(p, {add_target{}, migraphx::ref::target{}});
+    EXPECT(p.is_compiled());
+    EXPECT(count_partitions(p) == 3);
+    auto result = run(p, params);
+    EXPECT(result.size() == 1);
+    EXPECT(result.front() == gold.front());
+}
+
+TEST_CASE(partition_single_target)
+{
+    auto p      = create_program();
+    auto params = create_params(p);
+    auto gold   = run(p, params);
+
+    migraphx::assignment_options options;
+    options.transfer_cost = 1;
+    migraphx::compile_partitions(p, {add_target{}, migraphx::ref::target{}}, {}, options);
+    EXPECT(count_partitions(p) == 1);
+    EXPECT(run(p, params).front() == gold.front());
+}
+
+TEST_CASE(partition_multiple_outputs)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {2, 3}};
+    auto x   = mm->add_parameter("x", s);
+    auto y   = mm->add_parameter("y", s);
+    auto one = mm->add_literal(migraphx::generate_literal(s, 1));
+    auto a   = mm->add_instruction(migraphx::make_op("add"), x, one);
+    auto b   = mm->add_instruction(migraphx::make_op("add"), a, y);
+    auto c   = mm->add_instruction(migraphx::make_op("mul"), a, b);
+    auto d   = mm->add_instruction(migraphx::make_op("relu"), c);
+    mm->add_return({d, b, one, x});
+    auto params = create_params(p);
+    auto gold   = run(p, params);
+
+    migraphx::compile_partitions(p, {add_target{}, migraphx::ref::target{}});
+    EXPECT(count_partitions(p) == 2);
+    auto result = run(p, params);
+    EXPECT(result.size() == gold.size());
+    for(std::size_t i = 0; i < gold.size(); i++)
+        EXPECT(result[i] == gold[i]);
+}
+
+TEST_CASE(partition_same_target_not_merged)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {3}};
+    auto x = mm->add_parameter("x", s);
+    auto y = mm->add_parameter("y", s);
+    auto a = mm->add_instruction(migraphx::make_op("add"), x, y);
+    auto b = mm->add_instruction(migraphx::make_op("mul"), x, y);
+    auto c = mm->add_instruction(migraphx::make_op("add"), x, y);
+    auto d = mm->add_instruction(migraphx::make_op("add"), c, x);
+    mm->add_return({a, b, d});
+    auto params = create_params(p);
+    auto gold   = run(p, params);
+
+    migraphx::compile_partitions(p, {add_target{}, migraphx::ref::target{}});
+    EXPECT(count_partitions(p) == 3);
+    std::vector<migraphx::operation> ops;
+    for(const auto& ins : *p.get_main_module())
+    {
+        if(ins.name() == "run_on_target")
+            ops.push_back(ins.get_operator());
+    }
+    EXPECT(ops.front() != ops.back());
+    EXPECT(ops.front() == ops.front());
+    EXPECT(ops.front().to_value().contains("program"));
+
+    // Both add partitions take x and y, but run different programs
+    migraphx::run_passes(*p.get_main_module(), {migraphx::eliminate_common_subexpression{}});
+    EXPECT(count_partitions(p) == 3);
+    auto result = run(p, params);
+    for(std::size_t i = 0; i < gold.size(); i++)
+        EXPECT(result[i] == gold[i]);
+}
+
+TEST_CASE(partition_save_load)
+{
+    migraphx::register_target(add_target{});
+    auto p      = create_program();
+    auto params = create_params(p);
+    auto gold   = run(p, params);
+
+    migraphx::compile_partitions(p, {add_target{}, migraphx::ref::target{}});
+    migraphx::program loaded;
+    loaded.from_value(p.to_value());
+    EXPECT(loaded.is_compiled());
+    EXPECT(count_partitions(loaded) == 3);
+    auto result = run(loaded, params);
+    EXPECT(result.front() == gold.front());
+}
+
+TEST_CASE(partition_unsupported)
+{
+    auto p = create_program();
+    EXPECT(test::throws([&] { migraphx::compile_partitions(p, {add_target{}}); }));
+}
+
+TEST_CASE(partition_cpu_ref)
+{
+    auto targets = migraphx::get_targets();
+    if(std::find(targets.begin(), targets.end(), "cpu") == targets.end())
+        return;
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_parameter("x", {migraphx::shape::float_type, {4, 8}});
+    auto i   = mm->add_parameter("i", {migraphx::shape::int32_type, {4, 8}});
+    auto a   = mm->add_instruction(migraphx::make_op("relu"), x);
+    auto b   = mm->add_instruction(
+        migraphx::make_op("convert", {{"target_type", migraphx::shape::int32_type}}), a);
+    auto c = mm->add_instruction(migraphx::make_op("add"), b, i);
+    auto d = mm->add_instruction(
+        migraphx::make_op("convert", {{"target_type", migraphx::shape::float_type}}), c);
+    mm->add_instruction(migraphx::make_op("softmax", {{"axis", 1}}), d);
+    auto params = create_params(p);
+    auto gold   = run(p, params);
+
+    migraphx::compile_partitions(p, {migraphx::make_target("cpu"), migraphx::ref::target{}});
+    EXPECT(count_partitions(p) > 1);
+    std::vector<float> result;
+    run(p, params).front().visit([&](auto output) { result.assign(output.begin(), output.end()); });
+    std::vector<float> expected;
+    gold.front().visit([&](auto output) { expected.assign(output.begin(), output.end()); });
+    EXPECT(migraphx::verify_range(result, expected));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,132 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/perf_counters.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/ref/target.hpp>
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include "test.hpp"
+
+TEST_CASE(estimate_dot)
+{
+    migraphx::module m;
+    auto a   = m.add_parameter("a", {migraphx::shape::float_type, {2, 3, 4}});
+    auto b   = m.add_parameter("b", {migraphx::shape::float_type, {2, 4, 5}});
+    auto dot = m.add_instruction(migraphx::make_op("dot"), a, b);
+    EXPECT(migraphx::estimate_flops(dot) == 2 * 2 * 3 * 5 * 4);
+    EXPECT(migraphx::estimate_bytes(dot) == (24 + 40 + 30) * 4);
+}
+
+TEST_CASE(estimate_convolution)
+{
+    migraphx::module m;
+    auto x    = m.add_parameter("x", {migraphx::shape::float_type, {1, 3, 8, 8}});
+    auto w    = m.add_parameter("w", {migraphx::shape::float_type, {4, 3, 3, 3}});
+    auto conv = m.add_instruction(migraphx::make_op("convolution"), x, w);
+    EXPECT(migraphx::estimate_flops(conv) == 2 * (4 * 6 * 6) * 27);
+}
+
+TEST_CASE(estimate_pointwise_and_views)
+{
+    migraphx::module m;
+    auto x = m.add_parameter("x", {migraphx::shape::float_type, {2, 3}});
+    auto y = m.add_instruction(migraphx::make_op("add"), x, x);
+    auto t = m.add_instruction(migraphx::make_op("transpose", {{"permutation", {1, 0}}}), y);
+    auto r = m.add_instruction(migraphx::make_op("reduce_sum", {{"axes", {1}}}), t);
+    EXPECT(migraphx::estimate_flops(y) == 6);
+    EXPECT(migraphx::estimate_bytes(y) == 3 * 6 * 4);
+    EXPECT(migraphx::estimate_flops(t) == 0);
+    EXPECT(migraphx::estimate_bytes(t) == 0);
+    EXPECT(migraphx::estimate_flops(r) == 6);
+    EXPECT(migraphx::estimate_flops(x) == 0);
+}
+
+TEST_CASE(counters)
+{
+    migraphx::perf_counters counters;
+    if(not counters.available())
+        return;
+    counters.start();
+    volatile double x = 0;
+    for(int i = 0; i < 100000; i++)
+        x = x + i;
+    auto values = counters.stop();
+    EXPECT(values.cycles > 0);
+    EXPECT(values.instructions > 0);
+    EXPECT(values.ipc() > 0);
+}
+
+TEST_CASE(counters_existing_threads)
+{
+    std::mutex m;
+    std::condition_variable cv;
+    bool done = false;
+    // A thread that already exists when the counters are opened, like a thread pool
+    migraphx::joinable_thread t{[&] {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&] { return done; });
+    }};
+    migraphx::perf_counters counters;
+    if(counters.available())
+        EXPECT(counters.threads() >= 2);
+    {
+        std::lock_guard<std::mutex> lock(m);
+        done = true;
+    }
+    cv.notify_all();
+}
+
+TEST_CASE(perf_report_roofline)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {16, 16}};
+    auto a = mm->add_parameter("a", s);
+    auto b = mm->add_parameter("b", s);
+    auto d = mm->add_instruction(migraphx::make_op("dot"), a, b);
+    mm->add_instruction(migraphx::make_op("relu"), d);
+    p.compile(migraphx::ref::target{});
+    migraphx::parameter_map params;
+    params["a"] = migraphx::generate_argument(s, 1);
+    params["b"] = migraphx::generate_argument(s, 2);
+
+    migraphx::perf_options options;
+    options.counters    = true;
+    options.peak_gflops = 100;
+    options.peak_gbs    = 10;
+    std::stringstream ss;
+    p.perf_report(ss, 2, params, 1, options);
+    auto report = ss.str();
+    EXPECT(report.find("GFLOP/s") != std::string::npos);
+    EXPECT(report.find("Roofline:") != std::string::npos);
+    EXPECT(report.find("bound") != std::string::npos);
+    if(migraphx::perf_counters{}.available())
+        EXPECT(report.find("GB/s measured") != std::string::npos);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -0,0 +1,154 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/pipeline.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/verify.hpp>
+#include <migraphx/ref/target.hpp>
+#include <sstream>
+#include "test.hpp"
+
+migraphx::program create_program()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {4, 3}};
+    auto x = mm->add_parameter("x", s);
+    auto y = mm->add_parameter("y", s);
+    auto a = mm->add_instruction(migraphx::make_op("add"), x, y);
+    auto b = mm->add_instruction(migraphx::make_op("mul"), a, y);
+    auto c = mm->add_instruction(migraphx::make_op("relu"), b);
+    auto d = mm->add_instruction(migraphx::make_op("sub"), c, x);
+    mm->add_return({d, a});
+    return p;
+}
+
+std::vector<migraphx::parameter_map> create_batches(const migraphx::program& p, std::size_t n)
+{
+    std::vector<migraphx::parameter_map> batches(n);
+    for(std::size_t i = 0; i < n; i++)
+    {
+        for(auto&& x : p.get_parameter_shapes())
+            batches[i][x.first] = migraphx::generate_argument(x.second, i + x.first.size());
+    }
+    return batches;
+}
+
+bool verify_batches(migraphx::program p,
+                    const std::vector<migraphx::parameter_map>& batches,
+                    const std::vector<std::vector<migraphx::argument>>& results)
+{
+    p.compile(migraphx::ref::target{});
+    if(results.size() != batches.size())
+        return false;
+    for(std::size_t i = 0; i < batches.size(); i++)
+    {
+        auto gold = p.eval(batches[i]);
+        if(gold.size() != results[i].size())
+            return false;
+        for(std::size_t j = 0; j < gold.size(); j++)
+        {
+            std::vector<float> expected;
+            std::vector<float> actual;
+            gold[j].visit([&](auto v) { expected.assign(v.begin(), v.end()); });
+            results[i][j].visit([&](auto v) { actual.assign(v.begin(), v.end()); });
+            if(not migraphx::verify_range(actual, expected))
+                return false;
+        }
+    }
+    return true;
+}
+
+TEST_CASE(pipeline_auto_stages)
+{
+    auto p       = create_program();
+    auto batches = create_batches(p, 7);
+    migraphx::pipeline_options options;
+    options.stages      = 2;
+    options.pin_threads = false;
+    migraphx::pipeline pl{p, migraphx::ref::target{}, options};
+    EXPECT(pl.stages() == 2);
+    auto results = pl.eval(batches);
+    EXPECT(verify_batches(p, batches, results));
+}
+
+TEST_CASE(pipeline_cut_points)
+{
+    auto p       = create_program();
+    auto batches = create_batches(p, 5);
+    migraphx::pipeline_options options;
+    options.cut_points = {3, 5};
+    options.queue_size = 1;
+    migraphx::pipeline pl{p, migraphx::ref::target{}, options};
+    EXPECT(pl.stages() == 3);
+    auto results = pl.eval(batches);
+    EXPECT(verify_batches(p, batches, results));
+
+    const auto& report = pl.get_report();
+    EXPECT(report.size() == 3);
+    EXPECT(report[0].instructions == 1);
+    EXPECT(report[1].instructions == 2);
+    EXPECT(report[2].instructions == 1);
+    for(const auto& r : report)
+    {
+        EXPECT(r.batches == batches.size());
+        EXPECT(r.utilization() >= 0 and r.utilization() <= 1);
+    }
+    std::stringstream ss;
+    pl.print_report(ss);
+    EXPECT(not ss.str().empty());
+}
+
+TEST_CASE(pipeline_more_stages_than_instructions)
+{
+    auto p       = create_program();
+    auto batches = create_batches(p, 3);
+    migraphx::pipeline_options options;
+    options.stages = 16;
+    migraphx::pipeline pl{p, migraphx::ref::target{}, options};
+    EXPECT(pl.stages() == 4);
+    EXPECT(verify_batches(p, batches, pl.eval(batches)));
+}
+
+TEST_CASE(pipeline_invalid_cut_points)
+{
+    auto p = create_program();
+    migraphx::pipeline_options options;
+    options.cut_points = {4, 3};
+    EXPECT(test::throws([&] { migraphx::pipeline(p, migraphx::ref::target{}, options); }));
+    options.cut_points = {3, 30};
+    EXPECT(test::throws([&] { migraphx::pipeline(p, migraphx::ref::target{}, options); }));
+}
+
+TEST_CASE(pipeline_missing_parameter)
+{
+    auto p       = create_program();
+    auto batches = create_batches(p, 4);
+    batches[2].erase("y");
+    migraphx::pipeline pl{p, migraphx::ref::target{}};
+    EXPECT(test::throws([&] { pl.eval(batches); }));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
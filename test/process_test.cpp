@@ -0,0 +1,63 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/process.hpp>
+#include <migraphx/tmp_dir.hpp>
+#include <migraphx/file_buffer.hpp>
+#include <test.hpp>
+
+using strings = std::vector<std::string>;
+
+TEST_CASE(split_simple)
+{
+    EXPECT(migraphx::split_command("c++  -c  main.cpp ") == strings{"c++", "-c", "main.cpp"});
+    EXPECT(migraphx::split_command("").empty());
+}
+
+TEST_CASE(split_quotes)
+{
+    EXPECT(migraphx::split_command(R"(echo "a b" 'c "d"' e\ f)") ==
+           strings{"echo", "a b", "c \"d\"", "e f"});
+    EXPECT(migraphx::split_command(R"(echo "" -D"X=\"1\"")") == strings{"echo", "", "-DX=\"1\""});
+    EXPECT(test::throws([] { migraphx::split_command("echo 'abc"); }));
+}
+
+TEST_CASE(process_read)
+{
+    EXPECT(migraphx::process{"echo hello 'big world'"}.read() == "hello big world\n");
+}
+
+TEST_CASE(process_cwd)
+{
+    migraphx::tmp_dir td{"process"};
+    migraphx::write_buffer((td.path / "data.txt").string(), std::vector<char>{'4', '2'});
+    EXPECT(migraphx::process{"cat data.txt"}.cwd(td.path).read() == "42");
+}
+
+TEST_CASE(process_fails)
+{
+    EXPECT(test::throws([] { migraphx::process{"false"}.exec(); }));
+    EXPECT(test::throws([] { migraphx::process{"migraphx-missing-command"}.exec(); }));
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
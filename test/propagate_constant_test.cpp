@@ -26,6 +26,7 @@
 #include <migraphx/pass_manager.hpp>
 #include <basic_ops.hpp>
 #include <migraphx/make_op.hpp>
+#include <migraphx/instruction.hpp>
 
 #include <test.hpp>
 
@@ -99,20 +100,20 @@ TEST_CASE(const_add_mul)
 
 TEST_CASE(const_add_scalar)
 {
-    migraphx::module m1;
-    auto one = m1.add_instruction(migraphx::make_op("scalar", {{"scalar_bcst_dims", {2, 2}}}),
-                                  m1.add_literal(1));
-    auto two = m1.add_instruction(migraphx::make_op("scalar", {{"scalar_bcst_dims", {2, 2}}}),
-                                  m1.add_literal(2));
-    auto sum = m1.add_instruction(migraphx::make_op("add"), one, two);
-    m1.add_instruction(pass_op{}, sum);
+    // Adding two broadcasted scalars would fold into a larger literal, so it is kept
+    auto create_module = [] {
+        migraphx::module m;
+        auto one = m.add_instruction(migraphx::make_op("scalar", {{"scalar_bcst_dims", {2, 2}}}),
+                                     m.add_literal(1));
+        auto two = m.add_instruction(migraphx::make_op("scalar", {{"scalar_bcst_dims", {2, 2}}}),
+                                     m.add_literal(2));
+        auto sum = m.add_instruction(migraphx::make_op("add"), one, two);
+        m.add_instruction(pass_op{}, sum);
+        return m;
+    };
+    auto m1 = create_module();
     run_pass(m1);
-
-    migraphx::module m2;
-    auto total =
-        m2.add_literal(migraphx::literal{{migraphx::shape::int32_type, {2, 2}}, {3, 3, 3, 3}});
-    m2.add_instruction(pass_op{}, total);
-    EXPECT(m1 == m2);
+    EXPECT(m1 == create_module());
 }
 
 TEST_CASE(const_scalar)
@@ -163,4 +164,71 @@ TEST_CASE(const_dot)
     EXPECT(m1 == m2);
 }
 
+TEST_CASE(const_broadcast_reduce)
+{
+    // The sum of a broadcasted literal is folded since it is smaller than its inputs
+    migraphx::module m1;
+    {
+        auto one = m1.add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", {4, 4}}}),
+                                      m1.add_literal(1.0f));
+        auto sum = m1.add_instruction(migraphx::make_op("add"), one, one);
+        auto r   = m1.add_instruction(migraphx::make_op("reduce_sum", {{"axes", {0, 1}}}), sum);
+        m1.add_instruction(pass_op{}, r);
+    }
+    run_pass(m1);
+
+    auto last = std::prev(m1.end());
+    EXPECT(last->inputs().front()->name() == "@literal");
+    EXPECT(last->inputs().front()->get_literal() ==
+           migraphx::literal{{migraphx::shape::float_type, {1, 1}}, {32.0f}});
+}
+
+TEST_CASE(const_dedup)
+{
+    migraphx::module m1;
+    {
+        auto one  = m1.add_literal(1);
+        auto two  = m1.add_literal(2);
+        auto sum1 = m1.add_instruction(migraphx::make_op("add"), one, two);
+        auto sum2 = m1.add_instruction(migraphx::make_op("add"), two, one);
+        m1.add_instruction(pass_op{}, sum1, sum2);
+    }
+    run_pass(m1);
+
+    migraphx::module m2;
+    {
+        auto total = m2.add_literal(3);
+        m2.add_instruction(pass_op{}, total, total);
+    }
+    EXPECT(m1 == m2);
+}
+
+TEST_CASE(const_memory_budget)
+{
+    auto create_module = [] {
+        migraphx::module m;
+        migraphx::shape s{migraphx::shape::float_type, {8}};
+        auto x = m.add_parameter("x", s);
+        std::vector<migraphx::instruction_ref> sums;
+        for(int i = 0; i < 4; i++)
+        {
+            auto a = m.add_literal(migraphx::literal{s, std::vector<float>(8, i)});
+            auto b = m.add_literal(migraphx::literal{s, std::vector<float>(8, 1)});
+            auto c = m.add_instruction(migraphx::make_op("add"), a, b);
+            sums.push_back(m.add_instruction(migraphx::make_op("mul"), c, x));
+        }
+        m.add_return(sums);
+        return m;
+    };
+    auto m1 = create_module();
+    migraphx::run_passes(m1,
+                         {migraphx::propagate_constant{64}, migraphx::dead_code_elimination{}});
+    auto m2 = create_module();
+    migraphx::run_passes(m2, {migraphx::propagate_constant{0}, migraphx::dead_code_elimination{}});
+    EXPECT(m1 == m2);
+    EXPECT(std::count_if(m1.begin(), m1.end(), [](const auto& ins) {
+               return ins.name() == "add";
+           }) == 0);
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
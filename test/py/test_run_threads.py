@@ -0,0 +1,109 @@
+#####################################################################################
+# The MIT License (MIT)
+#
+# Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#####################################################################################
+import migraphx, array, threading, time
+
+
+def create_buffer(t, data, shape):
+    a = array.array(t, data)
+    m = memoryview(bytearray(a.tobytes()))
+    return m.cast(t, shape)
+
+
+def create_program():
+    s = migraphx.shape(lens=[64, 64], type="float")
+    p = migraphx.program()
+    mm = p.get_main_module()
+    x = mm.add_parameter("x", s)
+    y = mm.add_parameter("y", s)
+    dot = mm.add_instruction(migraphx.op("dot"), [x, y])
+    relu = mm.add_instruction(migraphx.op("relu"), [dot])
+    mm.add_return([relu])
+    p.compile(migraphx.get_target("ref"))
+    return p
+
+
+def make_params(i):
+    x = create_buffer('f', [float((j + i) % 7 - 3) for j in range(64 * 64)],
+                      (64, 64))
+    y = create_buffer('f', [float(j % 5 - 2) for j in range(64 * 64)],
+                      (64, 64))
+    return {"x": x, "y": y}
+
+
+def test_preallocated_output():
+    p = create_program()
+    params = make_params(0)
+    expected = p.run(params)[-1].tolist()
+    out = create_buffer('f', [0.0] * (64 * 64), (64, 64))
+    result = p.run(params, [out])[-1]
+    assert out.tolist() == [expected[i:i + 64] for i in range(0, 64 * 64, 64)]
+    # The result is the output buffer rather than another copy
+    out[0, 0] = 1234.0
+    assert result.tolist()[0] == 1234.0
+
+
+def run_threads(programs):
+    nthreads = len(programs)
+    iterations = 8
+    expected = [
+        programs[i].run(make_params(i))[-1].tolist() for i in range(nthreads)
+    ]
+    errors = []
+
+    def run(i):
+        params = make_params(i)
+        out = create_buffer('f', [0.0] * (64 * 64), (64, 64))
+        for _ in range(iterations):
+            result = programs[i].run(params, [out])[-1].tolist()
+            if result != expected[i]:
+                errors.append(i)
+
+    start = time.time()
+    threads = [
+        threading.Thread(target=run, args=(i, )) for i in range(nthreads)
+    ]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    elapsed = time.time() - start
+    print("{} runs/sec".format(nthreads * iterations / elapsed))
+    assert not errors
+
+
+# Runs of the same program from several threads take turns
+def test_run_threads():
+    p = create_program()
+    run_threads([p] * 4)
+
+
+# Different programs run concurrently
+def test_run_programs_threads():
+    run_threads([create_program() for _ in range(4)])
+
+
+if __name__ == "__main__":
+    test_preallocated_output()
+    test_run_threads()
+    test_run_programs_threads()
@@ -22,6 +22,7 @@
  * THE SOFTWARE.
  */
 #include <iostream>
+#include <cmath>
 #include <vector>
 #include <migraphx/literal.hpp>
 #include <migraphx/operators.hpp>
@@ -1129,6 +1130,187 @@ TEST_CASE(int8_quantization_conv)
     }
 }
 
+static migraphx::program create_int8_dot_program()
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape sa{migraphx::shape::float_type, {4, 16}};
+    migraphx::shape sb{migraphx::shape::float_type, {16, 8}};
+    auto pa = mm->add_parameter("a", sa);
+    auto pb = mm->add_parameter("b", sb);
+    auto r  = mm->add_instruction(migraphx::make_op("dot"), pa, pb);
+    mm->add_return({r});
+    return p;
+}
+
+static std::vector<migraphx::parameter_map> create_int8_calibration(std::size_t n)
+{
+    std::vector<migraphx::parameter_map> cali_data;
+    migraphx::shape sa{migraphx::shape::float_type, {4, 16}};
+    migraphx::shape sb{migraphx::shape::float_type, {16, 8}};
+    for(std::size_t i = 0; i < n; i++)
+    {
+        migraphx::parameter_map m;
+        m["a"] = migraphx::generate_argument(sa, i);
+        m["b"] = migraphx::generate_argument(sb, i + n);
+        cali_data.push_back(m);
+    }
+    return cali_data;
+}
+
+TEST_CASE(int8_quantization_threads)
+{
+    migraphx::target t = migraphx::ref::target{};
+    auto cali_data     = create_int8_calibration(8);
+
+    auto p1 = create_int8_dot_program();
+    migraphx::int8_quantization_options options1;
+    options1.num_threads = 1;
+    migraphx::quantize_int8(p1, t, cali_data, {"dot"}, options1);
+
+    auto p2 = create_int8_dot_program();
+    migraphx::int8_quantization_options options2;
+    options2.num_threads = 4;
+    migraphx::quantize_int8(p2, t, cali_data, {"dot"}, options2);
+
+    auto p3 = create_int8_dot_program();
+    migraphx::quantize_int8(p3, t, cali_data, {"dot"});
+
+    EXPECT(p1 == p2);
+    EXPECT(p1 == p3);
+}
+
+TEST_CASE(int8_quantization_threads_error)
+{
+    migraphx::target t = migraphx::ref::target{};
+    auto cali_data     = create_int8_calibration(8);
+    cali_data[5]["a"]  = migraphx::generate_argument({migraphx::shape::float_type, {2, 16}});
+
+    auto p = create_int8_dot_program();
+    migraphx::int8_quantization_options options;
+    options.num_threads = 4;
+    EXPECT(test::throws([&] { migraphx::quantize_int8(p, t, cali_data, {"dot"}, options); }));
+}
+
+TEST_CASE(int8_quantization_percentile)
+{
+    migraphx::target t = migraphx::ref::target{};
+    auto cali_data     = create_int8_calibration(4);
+
+    auto p1 = create_int8_dot_program();
+    migraphx::quantize_int8(p1, t, cali_data, {"dot"});
+
+    // The full percentile covers the same range as the max absolute value
+    auto p2 = create_int8_dot_program();
+    migraphx::int8_quantization_options options;
+    options.method     = migraphx::int8_calibration::percentile;
+    options.percentile = 100.0;
+    migraphx::quantize_int8(p2, t, cali_data, {"dot"}, options);
+    EXPECT(p1 == p2);
+
+    auto p3            = create_int8_dot_program();
+    options.percentile = 50.0;
+    migraphx::quantize_int8(p3, t, cali_data, {"dot"}, options);
+    EXPECT(p1 != p3);
+}
+
+TEST_CASE(int8_quantization_entropy)
+{
+    migraphx::target t = migraphx::ref::target{};
+    auto cali_data     = create_int8_calibration(4);
+    // Add an outlier which is clipped by the entropy calibration
+    std::vector<float> a;
+    cali_data.front()["a"].visit([&](auto x) { a.assign(x.begin(), x.end()); });
+    a.front()              = 1000.0f;
+    cali_data.front()["a"] =
+        migraphx::literal{{migraphx::shape::float_type, {4, 16}}, a}.get_argument();
+
+    auto run_prog = [&](migraphx::program p) {
+        p.compile(t);
+        std::vector<float> result;
+        p.eval(cali_data.back()).back().visit([&](auto v) { result.assign(v.begin(), v.end()); });
+        return result;
+    };
+
+    auto p1              = create_int8_dot_program();
+    auto no_quant_result = run_prog(p1);
+
+    migraphx::int8_quantization_options options;
+    options.method = migraphx::int8_calibration::entropy;
+    migraphx::quantize_int8(p1, t, cali_data, {"dot"}, options);
+    auto entropy_result = run_prog(p1);
+
+    auto p2 = create_int8_dot_program();
+    migraphx::quantize_int8(p2, t, cali_data, {"dot"});
+    auto max_abs_result = run_prog(p2);
+
+    double entropy_error = 0;
+    double max_abs_error = 0;
+    migraphx::verify_range(entropy_result, no_quant_result, 80, &entropy_error);
+    migraphx::verify_range(max_abs_result, no_quant_result, 80, &max_abs_error);
+    EXPECT(entropy_error < max_abs_error);
+}
+
+TEST_CASE(int8_quantization_bins_throw)
+{
+    migraphx::target t = migraphx::ref::target{};
+    auto p             = create_int8_dot_program();
+    migraphx::int8_quantization_options options;
+    options.method = migraphx::int8_calibration::entropy;
+    options.bins   = 64;
+    EXPECT(test::throws(
+        [&] { migraphx::quantize_int8(p, t, create_int8_calibration(1), {"dot"}, options); }));
+}
+
+TEST_CASE(int8_quantization_per_channel)
+{
+    migraphx::target t = migraphx::ref::target{};
+    migraphx::shape sa{migraphx::shape::float_type, {4, 16}};
+    migraphx::shape sb{migraphx::shape::float_type, {16, 8}};
+    // The weights of each output channel have a very different range
+    std::vector<float> b(sb.elements());
+    for(std::size_t i = 0; i < b.size(); i++)
+        b[i] = float((i % 7) + 1) * std::pow(10.0f, float(i % 8) - 4.0f);
+    auto create_program = [&] {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        auto pa  = mm->add_parameter("a", sa);
+        auto lb  = mm->add_literal(migraphx::literal{sb, b});
+        auto r   = mm->add_instruction(migraphx::make_op("dot"), pa, lb);
+        mm->add_return({r});
+        return p;
+    };
+    std::vector<migraphx::parameter_map> cali_data = {{{"a", migraphx::generate_argument(sa)}}};
+
+    auto run_prog = [&](migraphx::program p) {
+        p.compile(t);
+        std::vector<float> result;
+        p.eval(cali_data.back()).back().visit([&](auto v) { result.assign(v.begin(), v.end()); });
+        return result;
+    };
+
+    auto p1              = create_program();
+    auto no_quant_result = run_prog(p1);
+
+    migraphx::int8_quantization_options options;
+    options.per_channel = true;
+    migraphx::quantize_int8(p1, t, cali_data, {"dot"}, options);
+    auto* mm = p1.get_main_module();
+    EXPECT(std::any_of(mm->begin(), mm->end(), [](auto ins) { return ins.name() == "quant_dot"; }));
+    EXPECT(std::none_of(mm->begin(), mm->end(), [](auto ins) { return ins.name() == "dot"; }));
+    auto per_channel_result = run_prog(p1);
+
+    auto p2 = create_program();
+    migraphx::quantize_int8(p2, t, cali_data, {"dot"});
+    auto per_tensor_result = run_prog(p2);
+
+    double per_channel_error = 0;
+    double per_tensor_error  = 0;
+    migraphx::verify_range(per_channel_result, no_quant_result, 80, &per_channel_error);
+    migraphx::verify_range(per_tensor_result, no_quant_result, 80, &per_tensor_error);
+    EXPECT(per_channel_error < per_tensor_error);
+}
+
 TEST_CASE(int8_subgraph)
 {
     auto create_program = [] {
@@ -26,6 +26,7 @@
 #include <cmath>
 #include <random>
 #include <limits>
+#include <numeric>
 #include <migraphx/literal.hpp>
 #include <migraphx/op/pooling.hpp>
 #include <migraphx/instruction.hpp>
@@ -1241,6 +1242,90 @@ TEST_CASE(conv2d_padding_stride_test)
     EXPECT(migraphx::verify_range(results_vector, s));
 }
 
+TEST_CASE(conv2d_group_stride_test)
+{
+    migraphx::shape a_shape{migraphx::shape::float_type, {2, 4, 5, 5}};
+    migraphx::shape c_shape{migraphx::shape::float_type, {6, 2, 3, 3}};
+    std::vector<float> a(a_shape.elements());
+    std::vector<float> c(c_shape.elements());
+    std::iota(a.begin(), a.end(), -20.0f);
+    std::transform(a.begin(), a.end(), a.begin(), [](auto x) { return x / 16.0f; });
+    std::iota(c.begin(), c.end(), -50.0f);
+    std::transform(c.begin(), c.end(), c.begin(), [](auto x) { return x / 32.0f; });
+
+    // Output is {2, 6, 3, 3} with a padding of 1 and a stride of 2
+    std::vector<float> gold(2 * 6 * 3 * 3, 0.0f);
+    for(int n = 0; n < 2; n++)
+        for(int k = 0; k < 6; k++)
+            for(int y = 0; y < 3; y++)
+                for(int x = 0; x < 3; x++)
+                    for(int ch = 0; ch < 2; ch++)
+                        for(int i = 0; i < 3; i++)
+                            for(int j = 0; j < 3; j++)
+                            {
+                                int iy = y * 2 + i - 1;
+                                int ix = x * 2 + j - 1;
+                                if(iy < 0 or iy >= 5 or ix < 0 or ix >= 5)
+                                    continue;
+                                int c_in = (k / 3) * 2 + ch;
+                                gold[((n * 6 + k) * 3 + y) * 3 + x] +=
+                                    a[((n * 4 + c_in) * 5 + iy) * 5 + ix] *
+                                    c[((k * 2 + ch) * 3 + i) * 3 + j];
+                            }
+
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto al  = mm->add_literal(migraphx::literal{a_shape, a});
+    auto cl  = mm->add_literal(migraphx::literal{c_shape, c});
+    mm->add_instruction(
+        migraphx::make_op("convolution", {{"padding", {1, 1}}, {"stride", {2, 2}}, {"group", 2}}),
+        al,
+        cl);
+    p.compile(migraphx::ref::target{});
+    auto result = p.eval({}).back();
+
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    EXPECT(migraphx::verify_range(results_vector, gold));
+}
+
+TEST_CASE(conv2d_dilation_test)
+{
+    migraphx::shape a_shape{migraphx::shape::float_type, {1, 1, 5, 5}};
+    migraphx::shape c_shape{migraphx::shape::float_type, {1, 1, 2, 2}};
+    std::vector<float> a(a_shape.elements());
+    std::iota(a.begin(), a.end(), 0.0f);
+    std::vector<float> c(c_shape.elements(), 1.0f);
+    // The kernel with a dilation of 2 adds the corners of each 3x3 window
+    std::vector<float> gold = {24, 28, 32, 44, 48, 52, 64, 68, 72};
+
+    // The transposed input is not standard, so it is convolved without im2col
+    for(bool transposed : {false, true})
+    {
+        std::vector<float> data = a;
+        if(transposed)
+        {
+            for(std::size_t i = 0; i < 5; i++)
+                for(std::size_t j = 0; j < 5; j++)
+                    data[j * 5 + i] = a[i * 5 + j];
+        }
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        auto al  = mm->add_literal(migraphx::literal{a_shape, data});
+        if(transposed)
+            al = mm->add_instruction(
+                migraphx::make_op("transpose", {{"permutation", {0, 1, 3, 2}}}), al);
+        auto cl = mm->add_literal(migraphx::literal{c_shape, c});
+        mm->add_instruction(migraphx::make_op("convolution", {{"dilation", {2, 2}}}), al, cl);
+        p.compile(migraphx::ref::target{});
+        auto result = p.eval({}).back();
+
+        std::vector<float> results_vector;
+        result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+        EXPECT(migraphx::verify_range(results_vector, gold));
+    }
+}
+
 TEST_CASE(conv2d_padding_test)
 {
     migraphx::program p;
@@ -1541,6 +1626,52 @@ TEST_CASE(deconv_3d_test)
     EXPECT(migraphx::verify_range(results_vector, gold));
 }
 
+TEST_CASE(deconv_stride_dilation_test)
+{
+    migraphx::shape x_shape{migraphx::shape::float_type, {2, 3, 3, 4}};
+    migraphx::shape w_shape{migraphx::shape::float_type, {3, 2, 2, 3}};
+    std::vector<float> x_data(x_shape.elements());
+    std::vector<float> w_data(w_shape.elements());
+    std::iota(x_data.begin(), x_data.end(), -30.0f);
+    std::iota(w_data.begin(), w_data.end(), -15.0f);
+
+    // Output is {2, 2, 5, 9} with a padding of 1, a stride of 2 and a dilation of 2
+    std::vector<float> gold(2 * 2 * 5 * 9, 0.0f);
+    for(int n = 0; n < 2; n++)
+        for(int ch = 0; ch < 3; ch++)
+            for(int y = 0; y < 3; y++)
+                for(int x = 0; x < 4; x++)
+                    for(int k = 0; k < 2; k++)
+                        for(int i = 0; i < 2; i++)
+                            for(int j = 0; j < 3; j++)
+                            {
+                                int oy = y * 2 + i * 2 - 1;
+                                int ox = x * 2 + j * 2 - 1;
+                                if(oy < 0 or oy >= 5 or ox < 0 or ox >= 9)
+                                    continue;
+                                gold[((n * 2 + k) * 5 + oy) * 9 + ox] +=
+                                    x_data[((n * 3 + ch) * 3 + y) * 4 + x] *
+                                    w_data[((ch * 2 + k) * 2 + i) * 3 + j];
+                            }
+
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    auto x   = mm->add_literal(migraphx::literal{x_shape, x_data});
+    auto w   = mm->add_literal(migraphx::literal{w_shape, w_data});
+
+    mm->add_instruction(
+        migraphx::make_op("deconvolution",
+                          {{"padding", {1, 1}}, {"stride", {2, 2}}, {"dilation", {2, 2}}}),
+        x,
+        w);
+    p.compile(migraphx::ref::target{});
+    auto result = p.eval({}).back();
+
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    EXPECT(migraphx::verify_range(results_vector, gold));
+}
+
 TEST_CASE(deconv_test)
 {
     migraphx::shape s{migraphx::shape::float_type, {1, 1, 3, 3}};
@@ -4791,6 +4922,42 @@ TEST_CASE(reduce_sum_axis2)
     EXPECT(results_vector == gold);
 }
 
+TEST_CASE(reduce_sum_long_axis)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {2, 5000}};
+    std::vector<float> data(s.elements());
+    std::iota(data.begin(), data.end(), 0);
+    auto l0 = mm->add_literal(migraphx::literal{s, data});
+    mm->add_instruction(migraphx::make_op("reduce_sum", {{"axes", {1}}}), l0);
+    p.compile(migraphx::ref::target{});
+    auto result = p.eval({}).back();
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    std::vector<float> gold{12497500, 37497500};
+    EXPECT(results_vector == gold);
+}
+
+TEST_CASE(reduce_max_wide_inner)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape s{migraphx::shape::float_type, {2, 300, 70}};
+    std::vector<float> data(s.elements());
+    std::iota(data.begin(), data.end(), 0);
+    auto l0 = mm->add_literal(migraphx::literal{s, data});
+    mm->add_instruction(migraphx::make_op("reduce_max", {{"axes", {1}}}), l0);
+    p.compile(migraphx::ref::target{});
+    auto result = p.eval({}).back();
+    std::vector<float> results_vector;
+    result.visit([&](auto output) { results_vector.assign(output.begin(), output.end()); });
+    std::vector<float> gold(140);
+    std::iota(gold.begin(), gold.begin() + 70, 299 * 70);
+    std::iota(gold.begin() + 70, gold.end(), 599 * 70);
+    EXPECT(results_vector == gold);
+}
+
 TEST_CASE(relu_test)
 {
     migraphx::program p;
@@ -23,6 +23,7 @@
  */
 
 #include <migraphx/shape.hpp>
+#include <migraphx/shape_for_each.hpp>
 #include <migraphx/serialize.hpp>
 #include <migraphx/ranges.hpp>
 #include <migraphx/permutation.hpp>
@@ -762,4 +763,58 @@ TEST_CASE(test_with_type)
     EXPECT(s.strides() == new_s.strides());
 }
 
+static void check_shape_for_each(const migraphx::shape& s)
+{
+    std::vector<std::vector<std::size_t>> indices;
+    migraphx::shape_for_each(s, [&](const auto& idx) { indices.push_back(idx); });
+    EXPECT(indices.size() == s.elements());
+    migraphx::shape ss{s.type(), s.lens()};
+    for(std::size_t i = 0; i < indices.size(); i++)
+        EXPECT(indices[i] == ss.multi(i));
+
+    migraphx::shape standard{s.type(), s.lens()};
+    std::array<migraphx::shape, 2> shapes = {standard, s};
+    std::vector<std::size_t> offsets;
+    std::size_t n = 0;
+    migraphx::shape_for_each_offset(shapes, [&](const auto& o) {
+        EXPECT(o[0] == n);
+        offsets.push_back(o[1]);
+        n++;
+    });
+    EXPECT(n == s.elements());
+    for(std::size_t i = 0; i < offsets.size(); i++)
+    {
+        EXPECT(offsets[i] == s.index(indices[i]));
+        EXPECT(offsets[i] == s.index(i));
+    }
+}
+
+TEST_CASE(shape_for_each_standard)
+{
+    check_shape_for_each({migraphx::shape::float_type, {2, 3, 4, 5}});
+}
+
+TEST_CASE(shape_for_each_transposed)
+{
+    check_shape_for_each({migraphx::shape::float_type, {2, 3, 4, 5}, {60, 1, 15, 3}});
+}
+
+TEST_CASE(shape_for_each_broadcast)
+{
+    check_shape_for_each({migraphx::shape::float_type, {2, 3, 4, 5}, {0, 1, 0, 0}});
+    check_shape_for_each({migraphx::shape::float_type, {2, 3, 4, 5}, {20, 0, 5, 1}});
+}
+
+TEST_CASE(shape_for_each_sliced)
+{
+    check_shape_for_each({migraphx::shape::float_type, {2, 3, 2, 5}, {60, 20, 5, 1}});
+    check_shape_for_each({migraphx::shape::float_type, {2, 3, 4, 2}, {60, 20, 5, 1}});
+}
+
+TEST_CASE(shape_for_each_scalar)
+{
+    check_shape_for_each(migraphx::shape{migraphx::shape::float_type});
+    check_shape_for_each({migraphx::shape::float_type, {1}, {0}});
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
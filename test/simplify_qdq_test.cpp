@@ -35,6 +35,7 @@
 #include <migraphx/verify.hpp>
 #include <migraphx/ref/target.hpp>
 #include <migraphx/apply_alpha_beta.hpp>
+#include <numeric>
 
 bool is_convolution(const migraphx::instruction& ins) { return ins.name() == "convolution"; }
 bool is_dot(const migraphx::instruction& ins) { return ins.name() == "dot"; }
@@ -390,6 +391,69 @@ TEST_CASE(conv_multi_scale)
     EXPECT(m1 == m2);
 }
 
+TEST_CASE(conv_per_channel)
+{
+    migraphx::shape s4{migraphx::shape::int8_type, {1280, 320, 1, 1}};
+    migraphx::shape s7{migraphx::shape::float_type, {1, 320, 7, 7}};
+    migraphx::shape s8{migraphx::shape::float_type, {1280}};
+    std::vector<float> wscales(s8.elements());
+    std::iota(wscales.begin(), wscales.end(), 1.0f);
+    std::vector<float> oscales(s8.elements());
+    std::transform(
+        wscales.begin(), wscales.end(), oscales.begin(), [](auto x) { return 0.5f * x; });
+
+    migraphx::module m1;
+    {
+        auto input   = m1.add_parameter("input", s7);
+        auto weights = m1.add_parameter("weights", s4);
+        auto scale   = m1.add_literal(0.5f);
+        auto wscale  = m1.add_literal(migraphx::literal{s8, wscales});
+        auto zero    = m1.add_literal(std::int8_t{0});
+
+        auto wscale_b = m1.add_instruction(
+            migraphx::make_op("broadcast", {{"axis", 0}, {"out_lens", s4.lens()}}), wscale);
+        auto zero_mb = m1.add_instruction(
+            migraphx::make_op("multibroadcast", {{"out_lens", s4.lens()}}), zero);
+        auto d1 = m1.add_instruction(
+            migraphx::make_op("dequantizelinear"), weights, wscale_b, zero_mb);
+        auto q1 = add_quantize_op(m1, "quantizelinear", input, scale, zero);
+        auto d5 = add_quantize_op(m1, "dequantizelinear", q1, scale, zero);
+        auto c1 = m1.add_instruction(migraphx::make_op("convolution",
+                                                       {{"padding", {0, 0, 0, 0}},
+                                                        {"stride", {1, 1}},
+                                                        {"dilation", {1, 1}},
+                                                        {"group", 1},
+                                                        {"padding_mode", 0}}),
+                                     d5,
+                                     d1);
+        m1.add_return({c1});
+    }
+
+    migraphx::module m2;
+    {
+        auto input   = m2.add_parameter("input", s7);
+        auto weights = m2.add_parameter("weights", s4);
+        auto scale   = m2.add_literal(0.5f);
+        auto zero    = m2.add_literal(std::int8_t{0});
+        auto oscale  = m2.add_literal(migraphx::literal{s8, oscales});
+
+        auto q1 = add_quantize_op(m2, "quantizelinear", input, scale, zero);
+        auto c1 = m2.add_instruction(migraphx::make_op("quant_convolution",
+                                                       {{"padding", {0, 0, 0, 0}},
+                                                        {"stride", {1, 1}},
+                                                        {"dilation", {1, 1}},
+                                                        {"group", 1},
+                                                        {"padding_mode", 0}}),
+                                     q1,
+                                     weights);
+        auto d6 = add_quantize_op(m2, "dequantizelinear", c1, oscale);
+        m2.add_return({d6});
+    }
+
+    run_pass(m1);
+    EXPECT(m1 == m2);
+}
+
 TEST_CASE(conv_bias_add)
 {
     migraphx::shape s4{migraphx::shape::int8_type, {1280, 320, 1, 1}};
@@ -749,4 +813,62 @@ TEST_CASE(dot_correctness)
     EXPECT(migraphx::verify_range(rv1, rv2));
 }
 
+TEST_CASE(dot_per_channel_correctness)
+{
+    migraphx::shape sh1{migraphx::shape::float_type, {10, 4}};
+    migraphx::shape sh2{migraphx::shape::float_type, {4, 12}};
+    migraphx::shape sh3{migraphx::shape::float_type, {10, 12}};
+    migraphx::shape ss{migraphx::shape::float_type, {12}};
+    std::vector<float> scales(ss.elements());
+    std::iota(scales.begin(), scales.end(), 1.0f);
+
+    migraphx::program p1;
+    {
+        auto* m1     = p1.get_main_module();
+        auto a       = m1->add_parameter("a", sh1);
+        auto b       = m1->add_parameter("b", sh2);
+        auto scale_a = m1->add_literal(0.4f);
+        auto scale_b = m1->add_literal(migraphx::literal{ss, scales});
+        auto zero    = m1->add_literal(std::int8_t{0});
+
+        auto q1 = add_quantize_op(*m1, "quantizelinear", a, scale_a, zero);
+        auto d1 = add_quantize_op(*m1, "dequantizelinear", q1, scale_a, zero);
+        // Broadcasting along axis 1 gives a scale per output channel of the weights
+        auto q2  = add_quantize_op(*m1, "quantizelinear", b, scale_b, zero);
+        auto d2  = add_quantize_op(*m1, "dequantizelinear", q2, scale_b, zero);
+        auto dot = m1->add_instruction(migraphx::make_op("dot"), d1, d2);
+        m1->add_return({dot});
+
+        run_pass(*m1);
+        EXPECT(std::any_of(
+            m1->begin(), m1->end(), [](auto ins) { return ins.name() == "quant_dot"; }));
+    }
+
+    migraphx::program p2;
+    {
+        auto* m2 = p2.get_main_module();
+        auto a   = m2->add_parameter("a", sh1);
+        auto b   = m2->add_parameter("b", sh2);
+        auto dot = m2->add_instruction(migraphx::make_op("dot"), a, b);
+        m2->add_return({dot});
+    }
+
+    std::vector<float> av(sh1.elements(), 10);
+    auto a = migraphx::argument(sh1, av.data());
+    std::vector<float> bv(sh2.elements());
+    for(std::size_t i = 0; i < bv.size(); i++)
+        bv[i] = 10.0f * scales[i % scales.size()];
+    auto b = migraphx::argument(sh2, bv.data());
+    p1.compile(migraphx::target(migraphx::ref::target{}));
+    p2.compile(migraphx::target(migraphx::ref::target{}));
+
+    auto result1 = p1.eval({{"a", a}, {"b", b}}).back();
+    std::vector<float> rv1(sh3.elements());
+    result1.visit([&](auto output) { rv1.assign(output.begin(), output.end()); });
+    auto result2 = p2.eval({{"a", a}, {"b", b}}).back();
+    std::vector<float> rv2(sh3.elements());
+    result2.visit([&](auto output) { rv2.assign(output.begin(), output.end()); });
+    EXPECT(migraphx::verify_range(rv1, rv2));
+}
+
 int main(int argc, const char* argv[]) { test::run(argc, argv); }
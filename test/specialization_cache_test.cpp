@@ -0,0 +1,156 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <migraphx/specialization_cache.hpp>
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/par_for.hpp>
+#include <migraphx/ref/target.hpp>
+#include <algorithm>
+#include "test.hpp"
+
+migraphx::program create_dyn_conv_program(std::size_t opt = 0)
+{
+    migraphx::program p;
+    auto* mm = p.get_main_module();
+    migraphx::shape input_dyn_shape{migraphx::shape::float_type,
+                                    {{1, 8, opt}, {3, 3, 0}, {4, 4, 0}, {4, 4, 0}}};
+    migraphx::shape weights_shape{migraphx::shape::float_type, {2, 3, 3, 3}};
+    auto input   = mm->add_parameter("X", input_dyn_shape);
+    auto weights = mm->add_parameter("W", weights_shape);
+    mm->add_instruction(migraphx::make_op("convolution", {{"padding", {1, 1}}, {"stride", {2, 2}}}),
+                        input,
+                        weights);
+    return p;
+}
+
+migraphx::parameter_map create_params(std::size_t batch)
+{
+    migraphx::parameter_map params;
+    params["X"] = migraphx::generate_argument({migraphx::shape::float_type, {batch, 3, 4, 4}}, 1);
+    params["W"] = migraphx::generate_argument({migraphx::shape::float_type, {2, 3, 3, 3}}, 2);
+    return params;
+}
+
+TEST_CASE(specialize_program_shapes)
+{
+    auto p = create_dyn_conv_program();
+    auto sp =
+        migraphx::specialize_program(p, {{"X", {migraphx::shape::float_type, {5, 3, 4, 4}}}});
+    EXPECT(not sp.get_parameter_shape("X").dynamic());
+    EXPECT(sp.get_parameter_shape("X").lens() == std::vector<std::size_t>{5, 3, 4, 4});
+    auto out = sp.get_output_shapes().front();
+    EXPECT(not out.dynamic());
+    EXPECT(out.lens() == std::vector<std::size_t>{5, 2, 2, 2});
+    // The original program is not modified
+    EXPECT(p.get_parameter_shape("X").dynamic());
+}
+
+TEST_CASE(specialize_program_out_of_range)
+{
+    auto p = create_dyn_conv_program();
+    EXPECT(test::throws([&] {
+        migraphx::specialize_program(p, {{"X", {migraphx::shape::float_type, {9, 3, 4, 4}}}});
+    }));
+    EXPECT(test::throws([&] {
+        migraphx::specialize_program(p, {{"X", {migraphx::shape::float_type, {2, 3, 5, 4}}}});
+    }));
+    EXPECT(test::throws([&] { migraphx::specialize_program(p, {}); }));
+}
+
+TEST_CASE(specialization_cache_eval)
+{
+    auto dp = create_dyn_conv_program();
+    dp.compile(migraphx::ref::target{});
+
+    migraphx::specialization_cache cache{create_dyn_conv_program(), migraphx::ref::target{}};
+    for(std::size_t batch : {1, 4, 1, 4})
+    {
+        auto params = create_params(batch);
+        auto result = cache.eval(params).back();
+        auto gold   = dp.eval(params).back();
+        EXPECT(result.get_shape().lens() == gold.get_shape().lens());
+        EXPECT(result == gold);
+    }
+    EXPECT(cache.size() == 2);
+    EXPECT(cache.misses() == 2);
+    EXPECT(cache.hits() == 2);
+}
+
+TEST_CASE(specialization_cache_eval_threads)
+{
+    auto dp = create_dyn_conv_program();
+    dp.compile(migraphx::ref::target{});
+    auto params = create_params(3);
+    auto gold   = dp.eval(params).back();
+
+    migraphx::specialization_cache cache{create_dyn_conv_program(), migraphx::ref::target{}};
+    std::vector<migraphx::argument> results(8);
+    {
+        std::vector<migraphx::joinable_thread> threads;
+        for(std::size_t i = 0; i < results.size(); i++)
+            threads.emplace_back([&, i] { results[i] = cache.eval(params).back(); });
+    }
+    EXPECT(cache.size() == 1);
+    EXPECT(std::all_of(results.begin(), results.end(), [&](const auto& r) { return r == gold; }));
+}
+
+TEST_CASE(specialization_cache_lru)
+{
+    migraphx::specialization_cache cache{
+        create_dyn_conv_program(), migraphx::ref::target{}, migraphx::compile_options{}, 2};
+    cache.eval(create_params(1));
+    cache.eval(create_params(2));
+    // Make batch 1 the most recently used
+    cache.eval(create_params(1));
+    // Evicts batch 2
+    cache.eval(create_params(3));
+    EXPECT(cache.size() == 2);
+    EXPECT(cache.misses() == 3);
+    cache.eval(create_params(1));
+    EXPECT(cache.hits() == 2);
+    cache.eval(create_params(2));
+    EXPECT(cache.misses() == 4);
+    EXPECT(cache.size() == 2);
+}
+
+TEST_CASE(specialization_cache_warmup)
+{
+    migraphx::specialization_cache cache{create_dyn_conv_program(4), migraphx::ref::target{}};
+    cache.warmup();
+    EXPECT(cache.size() == 1);
+    EXPECT(cache.misses() == 1);
+    cache.eval(create_params(4));
+    EXPECT(cache.hits() == 1);
+    EXPECT(cache.size() == 1);
+}
+
+TEST_CASE(specialization_cache_warmup_no_opt)
+{
+    migraphx::specialization_cache cache{create_dyn_conv_program(), migraphx::ref::target{}};
+    cache.warmup();
+    EXPECT(cache.size() == 0);
+}
+
+int main(int argc, const char* argv[]) { test::run(argc, argv); }
@@ -199,6 +199,62 @@ TEST_CASE(value_copy_assign_keyless)
     EXPECT(v1.without_key() == v2.without_key());
 }
 
+TEST_CASE(value_copy_modify_array)
+{
+    migraphx::value v1 = {1, 2, 3};
+    migraphx::value v2 = v1;
+    v2[1]              = 5;
+    v2.push_back(4);
+    EXPECT(v1 == migraphx::value{1, 2, 3});
+    EXPECT(v2 == migraphx::value{1, 5, 3, 4});
+}
+
+TEST_CASE(value_copy_modify_nested)
+{
+    migraphx::value v1 = {{"a", {1, 2}}, {"b", 3}};
+    migraphx::value v2 = v1;
+    v2["a"].push_back(3);
+    v2.at("b") = 4;
+    EXPECT(v1.at("a").to_vector<int>() == std::vector<int>{1, 2});
+    EXPECT(v1.at("b").to<int>() == 3);
+    EXPECT(v2.at("a").to_vector<int>() == std::vector<int>{1, 2, 3});
+    EXPECT(v2.at("b").to<int>() == 4);
+}
+
+TEST_CASE(value_copy_clear)
+{
+    migraphx::value v1 = {{"a", 1}, {"b", 2}};
+    migraphx::value v2 = v1;
+    v2.clear();
+    EXPECT(v2.empty());
+    EXPECT(v2.is_object());
+    EXPECT(v1.size() == 2);
+}
+
+TEST_CASE(value_push_back_self)
+{
+    migraphx::value v = {1, 2};
+    v.push_back(v);
+    EXPECT(v.size() == 3);
+    EXPECT(v.back() == migraphx::value{1, 2});
+}
+
+TEST_CASE(value_large_object)
+{
+    migraphx::value v;
+    for(int i = 0; i < 40; i++)
+        v[std::to_string(i)] = i;
+    EXPECT(v.is_object());
+    EXPECT(v.size() == 40);
+    for(int i = 0; i < 40; i++)
+        EXPECT(v.at(std::to_string(i)).to<int>() == i);
+    EXPECT(not v.contains("40"));
+    migraphx::value v2 = v;
+    v2["40"]           = 40;
+    EXPECT(v2.contains("40"));
+    EXPECT(not v.contains("40"));
+}
+
 TEST_CASE(value_assign_key_string_literal_pair)
 {
     migraphx::value v = migraphx::value::object{};
@@ -893,6 +949,82 @@ TEST_CASE(value_binary_object_conv)
     EXPECT(migraphx::equal(v["data"].get_binary(), data));
 }
 
+TEST_CASE(value_binary_view)
+{
+    auto data = std::make_shared<std::vector<std::uint8_t>>(20);
+    std::iota(data->begin(), data->end(), 0);
+    migraphx::value v = {{"data", migraphx::value::binary_view{data->data(), data->size(), data}}};
+    std::weak_ptr<std::vector<std::uint8_t>> owner = data;
+    auto expected                                  = *data;
+    data.reset();
+    EXPECT(not owner.expired());
+
+    EXPECT(v["data"].is_binary());
+    auto view = v["data"].get_binary_view();
+    EXPECT(view.size == expected.size());
+    EXPECT(std::equal(view.data, view.data + view.size, expected.begin()));
+    EXPECT(v["data"].get_binary() == expected);
+    EXPECT(v["data"] == migraphx::value("data", migraphx::value::binary{expected}));
+
+    v = nullptr;
+    view = {};
+    EXPECT(owner.expired());
+}
+
+TEST_CASE(value_binary_view_of_binary)
+{
+    std::vector<std::uint8_t> data(20);
+    std::iota(data.begin(), data.end(), 0);
+    migraphx::value::binary_view view;
+    {
+        migraphx::value v = migraphx::value::binary{data};
+        view              = v.get_binary_view();
+    }
+    EXPECT(view.size == data.size());
+    EXPECT(std::equal(view.data, view.data + view.size, data.begin()));
+}
+
+TEST_CASE(value_inline_strings)
+{
+    std::string small = "relu";
+    std::string large(100, 'x');
+    migraphx::value a = small;
+    migraphx::value b = large;
+    auto c            = a;
+    auto d            = b;
+    EXPECT(c.is_string());
+    EXPECT(c.get_string() == small);
+    EXPECT(d.get_string() == large);
+    c = large;
+    d = small;
+    EXPECT(a.get_string() == small);
+    EXPECT(b.get_string() == large);
+    EXPECT(c.get_string() == large);
+    EXPECT(d.get_string() == small);
+    a = 1;
+    EXPECT(a.is_int64());
+    EXPECT(a.get_int64() == 1);
+    b = std::move(d);
+    EXPECT(b.get_string() == small);
+}
+
+TEST_CASE(value_inline_scalars_keep_key)
+{
+    migraphx::value v = {{"a", 1}, {"b", "short"}, {"c", true}, {"d", 2.5}};
+    migraphx::value w = v;
+    w["a"]            = 3;
+    w["b"]            = nullptr;
+    EXPECT(v.at("a").get_int64() == 1);
+    EXPECT(v.at("b").get_string() == "short");
+    EXPECT(w.at("a").get_int64() == 3);
+    EXPECT(w.at("a").get_key() == "a");
+    EXPECT(w.at("b").is_null());
+    EXPECT(w.at("b").get_key() == "b");
+    EXPECT(w.at("c").get_bool());
+    EXPECT(migraphx::float_equal(w.at("d").get_float(), 2.5));
+    EXPECT(v != w);
+}
+
 template <class T>
 bool is_null_type(T)
 {
@@ -169,7 +169,8 @@ void run_verify::verify(const std::string& name, const migraphx::program& p) con
     for(const auto& tname : migraphx::get_targets())
     {
         // TODO(varunsh): once verify tests can run, remove fpga
-        if(tname == "ref" or tname == "fpga")
+        // The partition target only runs programs already compiled by compile_partitions
+        if(tname == "ref" or tname == "fpga" or tname == "partition")
             continue;
 
         // if tests disabled, skip running it
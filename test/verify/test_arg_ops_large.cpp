@@ -0,0 +1,83 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+#include <migraphx/op/argmax.hpp>
+#include <migraphx/op/argmin.hpp>
+
+// Two rows longer than the chunks the cpu kernels split a long row into. The best value repeats
+// in every chunk of the first row, and first appears after the first chunk in the second row,
+// so merging the chunks has to keep the lowest index. Adding a parameter keeps the data from
+// being folded at compile time.
+static migraphx::instruction_ref add_tied_rows(migraphx::module& m, float sign)
+{
+    const std::size_t n = 70001;
+    migraphx::shape s{migraphx::shape::float_type, {2, n}};
+    std::vector<float> data(s.elements());
+    for(std::size_t i = 0; i < n; i++)
+        data[i] = sign * float(i % 1000);
+    for(std::size_t i : {40000, 50000, 70000})
+        data[n + i] = sign * 999.0f;
+    auto lit   = m.add_literal(migraphx::literal{s, data});
+    auto shift = m.add_parameter("shift", {migraphx::shape::float_type, {1}});
+    auto b =
+        m.add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", s.lens()}}), shift);
+    return m.add_instruction(migraphx::make_op("add"), lit, b);
+}
+
+template <class T>
+struct test_arg_ops_large : verify_program<test_arg_ops_large<T>>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        auto x   = add_tied_rows(*mm, std::is_same<T, migraphx::op::argmax>{} ? 1.0f : -1.0f);
+        mm->add_instruction(T{1}, x);
+        return p;
+    }
+};
+template struct test_arg_ops_large<migraphx::op::argmax>;
+template struct test_arg_ops_large<migraphx::op::argmin>;
+
+template <int Largest>
+struct test_topk_large : verify_program<test_topk_large<Largest>>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm = p.get_main_module();
+        auto x   = add_tied_rows(*mm, Largest == 1 ? 1.0f : -1.0f);
+        auto r   = mm->add_instruction(
+            migraphx::make_op("topk", {{"axis", 1}, {"k", 5}, {"largest", Largest}}), x);
+        auto r0 = mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 0}}), r);
+        auto r1 = mm->add_instruction(migraphx::make_op("get_tuple_elem", {{"index", 1}}), r);
+        mm->add_return({r0, r1});
+        return p;
+    }
+};
+template struct test_topk_large<0>;
+template struct test_topk_large<1>;
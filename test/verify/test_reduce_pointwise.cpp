@@ -0,0 +1,93 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2015-2022 Advanced Micro Devices, Inc. All rights reserved.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include "verify_program.hpp"
+#include <migraphx/program.hpp>
+#include <migraphx/generate.hpp>
+#include <migraphx/make_op.hpp>
+
+struct test_reduce_softmax_axis1 : verify_program<test_reduce_softmax_axis1>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm                 = p.get_main_module();
+        std::vector<size_t> dims = {2, 7, 5};
+        auto x   = mm->add_parameter("x", migraphx::shape{migraphx::shape::float_type, dims});
+        auto max = mm->add_instruction(migraphx::make_op("reduce_max", {{"axes", {1}}}), x);
+        auto max_mbcast =
+            mm->add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", dims}}), max);
+        auto sub = mm->add_instruction(migraphx::make_op("sub"), x, max_mbcast);
+        auto exp = mm->add_instruction(migraphx::make_op("exp"), sub);
+        auto sum = mm->add_instruction(migraphx::make_op("reduce_sum", {{"axes", {1}}}), exp);
+        auto sum_mbcast =
+            mm->add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", dims}}), sum);
+        mm->add_instruction(migraphx::make_op("div"), exp, sum_mbcast);
+        return p;
+    }
+};
+
+struct test_reduce_rmsnorm : verify_program<test_reduce_rmsnorm>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm                 = p.get_main_module();
+        std::vector<size_t> dims = {1, 4, 1000};
+        auto x = mm->add_parameter("x", migraphx::shape{migraphx::shape::float_type, dims});
+        auto scale =
+            mm->add_parameter("scale", migraphx::shape{migraphx::shape::float_type, {dims.back()}});
+        auto epsilon = mm->add_literal(1e-5f);
+        auto sq      = mm->add_instruction(migraphx::make_op("mul"), x, x);
+        auto mean    = mm->add_instruction(migraphx::make_op("reduce_mean", {{"axes", {2}}}), sq);
+        auto epsilon_mbcast = mm->add_instruction(
+            migraphx::make_op("multibroadcast", {{"out_lens", {1, dims.at(1), 1}}}), epsilon);
+        auto add   = mm->add_instruction(migraphx::make_op("add"), mean, epsilon_mbcast);
+        auto rsqrt = mm->add_instruction(migraphx::make_op("rsqrt"), add);
+        auto rsqrt_mbcast =
+            mm->add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", dims}}), rsqrt);
+        auto norm = mm->add_instruction(migraphx::make_op("mul"), x, rsqrt_mbcast);
+        auto scale_mbcast =
+            mm->add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", dims}}), scale);
+        mm->add_instruction(migraphx::make_op("mul"), norm, scale_mbcast);
+        return p;
+    }
+};
+
+struct test_reduce_variance : verify_program<test_reduce_variance>
+{
+    migraphx::program create_program() const
+    {
+        migraphx::program p;
+        auto* mm                 = p.get_main_module();
+        std::vector<size_t> dims = {3, 16, 8};
+        auto x    = mm->add_parameter("x", migraphx::shape{migraphx::shape::float_type, dims});
+        auto mean = mm->add_instruction(migraphx::make_op("reduce_mean", {{"axes", {1, 2}}}), x);
+        auto mean_mbcast =
+            mm->add_instruction(migraphx::make_op("multibroadcast", {{"out_lens", dims}}), mean);
+        auto sub = mm->add_instruction(migraphx::make_op("sub"), x, mean_mbcast);
+        auto sq  = mm->add_instruction(migraphx::make_op("mul"), sub, sub);
+        mm->add_instruction(migraphx::make_op("reduce_mean", {{"axes", {1, 2}}}), sq);
+        return p;
+    }
+};
@@ -80,6 +80,12 @@ struct operation
     /// An optional method to return which argument the output will alias. If
     /// there is no aliased output then -1 can be returned.
     std::ptrdiff_t output_alias(const std::vector<shape>& input) const;
+    /// An optional hash of the name and reflected members, consistent with equality. It does
+    /// not serialize the operation.
+    std::size_t hash() const;
+    /// An optional accessor returning the member with the given name, or a null value when
+    /// there is none, without serializing the other members.
+    value field(const std::string& key) const;
     /// An optional stream operator to print the operation. When this is not
     /// implemented, it will just print the operation's name.
     friend std::ostream& operator<<(std::ostream& os, const operation& op);
@@ -462,6 +468,40 @@ void from_value_op(T& x, const value& v)
     return migraphx::from_value(v, x);
 }
 
+template <class T>
+std::size_t hash_op(const T& x)
+{
+    std::size_t result = std::hash<std::string>{}(x.name());
+    hash_combine(result, reflect_hash(x));
+    return result;
+}
+
+template <class T>
+auto field_op(rank<1>, const T& x, const std::string& name) -> decltype(x.to_value())
+{
+    auto v = x.to_value();
+    if(not v.contains(name))
+        return {};
+    return v.at(name).without_key();
+}
+
+template <class T>
+value field_op(rank<0>, const T& x, const std::string& name)
+{
+    value result;
+    reflect_each(x, [&](auto&& y, auto&& field_name) {
+        if(field_name == name)
+            result = migraphx::to_value(y);
+    });
+    return result;
+}
+
+template <class T>
+value field_op(const T& x, const std::string& name)
+{
+    return field_op(rank<1>{}, x, name);
+}
+
 template <class T>
 lifetime get_lifetime_op(const T&)
 {
@@ -547,6 +587,12 @@ lifetime get_lifetime_op(const T&)
      virtual('to_value', returns = 'value', const = True, default = 'detail::to_value_op'),
      virtual('from_value', v = 'const value&', default = 'detail::from_value_op'),
      virtual('attributes', returns = 'value', const = True, default = 'detail::attributes_op'),
+     virtual('hash', returns = 'std::size_t', const = True, default = 'detail::hash_op'),
+     virtual('field',
+             returns = 'value',
+             key     = 'const std::string&',
+             const   = True,
+             default = 'detail::field_op'),
      friend('operator<<',
             returns = 'std::ostream &',
             os      = 'std::ostream &',